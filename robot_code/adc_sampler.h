@@ -0,0 +1,132 @@
+// Smart Waiter Robot - Interrupt-driven Line Sensor Sampling
+// Converts the line sensor inputs (A0, A1, A2 by default) one after another
+// from the ADC-complete interrupt, so the control loop never waits on the
+// ~110 us blocking analogRead(). Each finished round of channels is
+// published in one of two buffers; a snapshot is always a complete round
+// with the time it finished.
+//
+// The sketch forwards the interrupt:
+//   ISR(ADC_vect) { lineSensors.onConversionComplete(); }
+//
+// Off AVR (IntelliSense, host builds) snapshot() falls back to analogRead().
+
+#ifndef ADC_SAMPLER_H
+#define ADC_SAMPLER_H
+
+const unsigned char kAdcChannels = 3;
+
+// ADC clock divider (ADPS bits): 16 MHz / 128 = 125 kHz is the slowest and
+// most accurate. Each conversion takes 13 ADC clocks.
+enum AdcPrescaler {
+  ADC_PRESCALER_16 = 4,  // 1 MHz, ~77k conversions/s (8-bit accuracy)
+  ADC_PRESCALER_32 = 5,  // 500 kHz, ~38k conversions/s
+  ADC_PRESCALER_64 = 6,  // 250 kHz, ~19k conversions/s
+  ADC_PRESCALER_128 = 7  // 125 kHz, ~9.6k conversions/s (full 10-bit)
+};
+
+// One complete round. Values are always on the 0-1023 scale; in 8-bit mode
+// the low two bits are zero.
+struct AdcSnapshot {
+  unsigned int value[kAdcChannels];
+  unsigned long micros;    // When the last channel of the round finished
+  unsigned long sequence;  // Round counter, increases by one per round
+};
+
+class AdcSampler {
+public:
+  AdcSampler(unsigned char firstPin)
+    : firstPin(firstPin), fastMode(false), muxBase(0), channel(0), writeIndex(0),
+      readyIndex(1), rounds(0) {
+    for (unsigned char b = 0; b < 2; b++) {
+      for (unsigned char i = 0; i < kAdcChannels; i++) {
+        buffers[b].value[i] = 0;
+      }
+      buffers[b].micros = 0;
+      buffers[b].sequence = 0;
+    }
+  }
+
+  // Start sampling. In fast mode only the top 8 bits are read (ADLAR), which
+  // stays accurate at the higher ADC clocks.
+  void begin(AdcPrescaler prescaler = ADC_PRESCALER_128, bool eightBit = false) {
+    fastMode = eightBit;
+#ifdef __AVR__
+    muxBase = (1 << REFS0) | (eightBit ? (1 << ADLAR) : 0);
+    channel = 0;
+    ADCSRB = 0;
+    ADMUX = muxBase | ((firstPin - A0) & 0x07);
+    // Enable, start the first conversion and interrupt on completion; every
+    // following conversion is started from the interrupt
+    ADCSRA = (1 << ADEN) | (1 << ADSC) | (1 << ADIE) | (prescaler & 0x07);
+#else
+    (void)prescaler;
+#endif
+  }
+
+  // Stop converting (e.g. before using analogRead() elsewhere)
+  void end() {
+#ifdef __AVR__
+    ADCSRA &= ~(1 << ADIE);
+#endif
+  }
+
+  // Called from ISR(ADC_vect)
+  void onConversionComplete() {
+#ifdef __AVR__
+    unsigned int value = fastMode ? (unsigned int)ADCH << 2 : ADC;
+    AdcSnapshot &round = buffers[writeIndex];
+    round.value[channel] = value;
+
+    if (++channel >= kAdcChannels) {
+      channel = 0;
+      round.micros = micros();
+      round.sequence = ++rounds;
+      readyIndex = writeIndex;
+      writeIndex ^= 1;
+    }
+
+    // Next channel, then restart. Chaining conversions from the interrupt
+    // (rather than the hardware free-running mode, where a mux change only
+    // applies one conversion later) keeps each result matched to its
+    // channel even when SoftwareSerial holds interrupts off.
+    ADMUX = muxBase | ((firstPin - A0 + channel) & 0x07);
+    ADCSRA |= (1 << ADSC);
+#endif
+  }
+
+  // Copy the most recent complete round. Returns true if it is newer than
+  // the round passed in (compare by sequence).
+  bool snapshot(AdcSnapshot &out) {
+#ifdef __AVR__
+    unsigned long previous = out.sequence;
+    unsigned char oldSREG = SREG;
+    cli();
+    out = buffers[readyIndex];
+    SREG = oldSREG;
+    return out.sequence != previous;
+#else
+    for (unsigned char i = 0; i < kAdcChannels; i++) {
+      out.value[i] = analogRead(firstPin + i);
+    }
+    out.micros = micros();
+    out.sequence = ++rounds;
+    return true;
+#endif
+  }
+
+  bool eightBitMode() const { return fastMode; }
+
+private:
+  unsigned char firstPin;
+  bool fastMode;
+  unsigned char muxBase;
+
+  // Written by the interrupt
+  volatile unsigned char channel;
+  volatile unsigned char writeIndex;
+  volatile unsigned char readyIndex;
+  volatile unsigned long rounds;
+  AdcSnapshot buffers[2];
+};
+
+#endif
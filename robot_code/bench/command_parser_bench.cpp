@@ -0,0 +1,54 @@
+// Host benchmark for command_parser.h
+//
+// Build and run from robot_code/:
+//   g++ -O2 -std=c++11 -I. bench/command_parser_bench.cpp -o parser_bench
+//   ./parser_bench
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#include "command_parser.h"
+
+static const char *const kCommands[] = {
+  "{\"command\": \"go_to_table\", \"table_number\": 3}",
+  "{\"command\":\"go_to_table\",\"table_number\":\"5\"}",
+  "{\"command\": \"return_home\"}",
+  "{\"command\": \"stop\"}",
+  "{\"command\": \"status\"}",
+  "GO3",
+  "go 4",
+  "HOME",
+  "STOP",
+  "STATUS",
+  "{\"command\": \"dance\"}"
+};
+
+int main() {
+  const unsigned int commandCount = sizeof(kCommands) / sizeof(kCommands[0]);
+  const unsigned long iterations = 2000000;
+
+  unsigned int lengths[commandCount];
+  for (unsigned int i = 0; i < commandCount; i++) {
+    lengths[i] = (unsigned int)strlen(kCommands[i]);
+  }
+
+  CommandParser parser;
+  RobotCommand command;
+  unsigned long checksum = 0;
+
+  printf("%-52s %10s\n", "command", "ns/parse");
+  for (unsigned int i = 0; i < commandCount; i++) {
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned long n = 0; n < iterations; n++) {
+      parser.parse(kCommands[i], lengths[i], command);
+      checksum += command.id + command.args[0];
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    double ns = std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+    printf("%-52s %10.1f\n", kCommands[i], ns);
+  }
+
+  printf("checksum %lu\n", checksum);
+  return 0;
+}
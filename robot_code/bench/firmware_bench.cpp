@@ -0,0 +1,406 @@
+// Host benchmark for the firmware's hot paths
+// Runs the sketch's own loop(), processCommand(), followLine() and
+// sendStatus() against the host Arduino core (sim/) with realistic input:
+// JSON and text command lines, a recorded-style sensor trace of a robot
+// weaving over the line, and status replies in every state and format.
+// For each case it reports the time per call, String heap allocations per
+// call (counted by the host core) and the bytes the call sends on the
+// Bluetooth link and the USB serial log.
+//
+// Build with the host build (CMakeLists.txt), then from robot_code/:
+//   ./build/firmware_bench --out bench.json
+//   ./build/firmware_bench --baseline bench.json
+//
+// options:
+//   --out FILE        write the results as JSON
+//   --baseline FILE   compare with an earlier --out; exit 1 on a regression
+//   --threshold PCT   slowdown that counts as a regression (default 75)
+//   --filter TEXT     only cases whose name contains TEXT
+//   --rounds N        timing rounds per case (default 9)
+//   --min-ms N        time each round for at least N ms (default 50)
+//
+// Allocations and bytes are exact and must not grow at all. Times are
+// noisy: each case is timed in several rounds and the median is reported
+// and compared, with the spread between rounds alongside. On the one-CPU
+// build VM the median of a case moved by up to 61% between five runs, so
+// the default threshold sits above that; pass a tighter --threshold on a
+// quieter machine. Compare runs from the same machine.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "host_board.h"
+#include "reply_builder.h"
+
+// The sketch (smart_waiter_robot.ino)
+typedef ReplyBuilder<kReplyCapacity> Reply;
+extern bool binaryLink;
+void setup();
+void loop();
+void processCommand(const char *line, unsigned int length);
+void followLine();
+void sendStatus(Reply &reply);
+
+namespace {
+
+const uint8_t kBluetoothRxPin = 11;
+const uint8_t kFirstSensorPin = 14;
+const int kSensors = 3;
+
+// A second of sensor readings at the line task's 1 kHz: the robot weaves
+// +/-8 mm over 19 mm tape, sensors 18 mm apart with a 5 mm spot, reading
+// 850 on floor and 150 on tape (the simulator's robot), with a little noise
+class SensorTrace {
+public:
+  SensorTrace() {
+    uint32_t noise = 1;
+    for (int sample = 0; sample < kSamples; sample++) {
+      double offset = 8 * std::sin(2 * 3.14159265358979 * sample / 700.0);
+      for (int sensor = 0; sensor < kSensors; sensor++) {
+        double d = std::fabs((sensor - 1) * 18.0 - offset);
+        double covered = std::max(0.0, std::min(1.0, (9.5 + 5 - d) / 10));
+        noise = noise * 1103515245u + 12345u;
+        int jitter = (int)((noise >> 16) % 21) - 10;
+        readings_[sample][sensor] = (int)(850 - 700 * covered) + jitter;
+      }
+    }
+  }
+
+  // analogRead() source; moves to the next sample after the last sensor
+  int read(uint8_t pin) {
+    int sensor = pin - kFirstSensorPin;
+    if (sensor < 0 || sensor >= kSensors) {
+      return 0;
+    }
+    int value = readings_[sample_][sensor];
+    if (sensor == kSensors - 1) {
+      sample_ = (sample_ + 1) % kSamples;
+    }
+    return value;
+  }
+
+private:
+  static const int kSamples = 1000;
+  int readings_[kSamples][kSensors];
+  int sample_ = 0;
+};
+
+struct Result {
+  std::string name;
+  double nsPerOp = 0;      // Median of the rounds
+  double nsMin = 0;        // Fastest round
+  double spreadPercent = 0; // Slowest round over the fastest
+  double allocsPerOp = 0;
+  double btBytesPerOp = 0;
+  double serialBytesPerOp = 0;
+  unsigned long ops = 0;
+};
+
+class Bench {
+public:
+  Bench(int rounds, double minMs, const std::string &filter)
+    : rounds_(rounds), minMs_(minMs), filter_(filter) {}
+
+  // Time op(), called over and over, in rounds of at least minMs each.
+  // prepare() puts the firmware in the state the case needs; it is not
+  // timed.
+  void run(const std::string &name, const std::function<void()> &prepare,
+           const std::function<void()> &op) {
+    if (!filter_.empty() && name.find(filter_) == std::string::npos) {
+      return;
+    }
+    sim::HostBoard &board = sim::board();
+    prepare();
+    op();  // Warm up
+    drain();
+
+    Result result;
+    result.name = name;
+    unsigned long allocations = board.heap().allocations;
+    size_t btBytes = 0;
+    size_t serialBytes = 0;
+    unsigned long batch = 64;
+    std::vector<double> roundNs;
+    for (int round = 0; round < rounds_; round++) {
+      double elapsedNs = 0;
+      unsigned long ops = 0;
+      while (elapsedNs < minMs_ * 1e6) {
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned long i = 0; i < batch; i++) {
+          op();
+        }
+        double batchNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() -
+                                                                  start).count();
+        elapsedNs += batchNs;
+        ops += batch;
+        btBytes += bluetooth().output().size() + rendered_;
+        rendered_ = 0;
+        serialBytes += board.serial().output().size();
+        drain();
+        // Grow the batch until it is a slice of a round, then keep it, so
+        // later rounds are the same length
+        if (batchNs < minMs_ * 1e6 / 8 && batch < (1UL << 20)) {
+          batch *= 2;
+        }
+      }
+      roundNs.push_back(elapsedNs / ops);
+      result.ops += ops;
+    }
+    std::sort(roundNs.begin(), roundNs.end());
+    size_t middle = roundNs.size() / 2;
+    result.nsPerOp = roundNs.size() % 2 ? roundNs[middle]
+                                        : (roundNs[middle - 1] + roundNs[middle]) / 2;
+    result.nsMin = roundNs.front();
+    result.spreadPercent = (roundNs.back() / roundNs.front() - 1) * 100;
+    result.allocsPerOp = (double)(board.heap().allocations - allocations) / result.ops;
+    result.btBytesPerOp = (double)btBytes / result.ops;
+    result.serialBytesPerOp = (double)serialBytes / result.ops;
+    std::printf("%-28s %10.1f %7.1f%% %9.2f %9.1f %9.1f\n", name.c_str(), result.nsPerOp,
+                result.spreadPercent, result.allocsPerOp, result.btBytesPerOp,
+                result.serialBytesPerOp);
+    results_.push_back(result);
+  }
+
+  const std::vector<Result> &results() const { return results_; }
+
+  static sim::VirtualPort &bluetooth() { return sim::board().softwareSerial(kBluetoothRxPin); }
+
+  static void drain() {
+    bluetooth().takeOutput();
+    sim::board().serial().takeOutput();
+    rendered_ = 0;
+  }
+
+  // Bytes of a reply an op built but did not send
+  static void rendered(size_t bytes) { rendered_ += bytes; }
+
+private:
+  static size_t rendered_;
+
+  int rounds_;
+  double minMs_;
+  std::string filter_;
+  std::vector<Result> results_;
+};
+
+size_t Bench::rendered_ = 0;
+
+void command(const char *line) {
+  processCommand(line, (unsigned int)std::strlen(line));
+}
+
+// One call per op, cycling through the lines
+std::function<void()> commands(std::vector<const char *> lines) {
+  std::vector<unsigned int> lengths;
+  for (const char *line : lines) {
+    lengths.push_back((unsigned int)std::strlen(line));
+  }
+  size_t next = 0;
+  return [lines, lengths, next]() mutable {
+    processCommand(lines[next], lengths[next]);
+    next = (next + 1) % lines.size();
+  };
+}
+
+void writeResults(const std::string &path, const std::vector<Result> &results) {
+  FILE *out = std::fopen(path.c_str(), "w");
+  if (!out) {
+    std::fprintf(stderr, "firmware_bench: cannot write %s\n", path.c_str());
+    std::exit(2);
+  }
+  // One case per line, so a baseline can be read back without a JSON parser.
+  // ns_per_op is the median round.
+  std::fprintf(out, "{\"benchmark\":\"firmware_bench\",\"results\":[\n");
+  for (size_t i = 0; i < results.size(); i++) {
+    const Result &r = results[i];
+    std::fprintf(out,
+                 "{\"name\":\"%s\",\"ns_per_op\":%.1f,\"allocs_per_op\":%.3f,"
+                 "\"bt_bytes_per_op\":%.2f,\"serial_bytes_per_op\":%.2f,\"ops\":%lu,"
+                 "\"ns_min\":%.1f,\"spread_pct\":%.1f}%s\n",
+                 r.name.c_str(), r.nsPerOp, r.allocsPerOp, r.btBytesPerOp, r.serialBytesPerOp,
+                 r.ops, r.nsMin, r.spreadPercent, i + 1 < results.size() ? "," : "");
+  }
+  std::fprintf(out, "]}\n");
+  std::fclose(out);
+}
+
+bool readBaseline(const std::string &path, std::vector<Result> &baseline) {
+  std::ifstream in(path);
+  if (!in) {
+    return false;
+  }
+  std::string line;
+  while (std::getline(in, line)) {
+    char name[128];
+    Result r;
+    if (std::sscanf(line.c_str(),
+                    "{\"name\":\"%127[^\"]\",\"ns_per_op\":%lf,\"allocs_per_op\":%lf,"
+                    "\"bt_bytes_per_op\":%lf,\"serial_bytes_per_op\":%lf",
+                    name, &r.nsPerOp, &r.allocsPerOp, &r.btBytesPerOp,
+                    &r.serialBytesPerOp) == 5) {
+      r.name = name;
+      baseline.push_back(r);
+    }
+  }
+  return true;
+}
+
+// Print the change per case; false if any case regressed
+bool compare(const std::vector<Result> &results, const std::vector<Result> &baseline,
+             double thresholdPercent) {
+  bool ok = true;
+  std::printf("\n%-28s %10s %10s %8s  %s\n", "vs baseline", "ns/op", "was", "change", "");
+  for (const Result &r : results) {
+    const Result *old = nullptr;
+    for (const Result &b : baseline) {
+      if (b.name == r.name) {
+        old = &b;
+      }
+    }
+    if (!old) {
+      std::printf("%-28s %10.1f %10s\n", r.name.c_str(), r.nsPerOp, "new");
+      continue;
+    }
+    double change = old->nsPerOp > 0 ? (r.nsPerOp / old->nsPerOp - 1) * 100 : 0;
+    std::string verdict;
+    if (change > thresholdPercent) {
+      verdict = "SLOWER";
+    }
+    // Exact counts: any growth is a regression
+    if (r.allocsPerOp > old->allocsPerOp + 1e-9) {
+      verdict += verdict.empty() ? "MORE ALLOCS" : ", MORE ALLOCS";
+    }
+    if (r.btBytesPerOp > old->btBytesPerOp + 1e-9 ||
+        r.serialBytesPerOp > old->serialBytesPerOp + 1e-9) {
+      verdict += verdict.empty() ? "MORE BYTES" : ", MORE BYTES";
+    }
+    ok = ok && verdict.empty();
+    std::printf("%-28s %10.1f %10.1f %+7.1f%%  %s\n", r.name.c_str(), r.nsPerOp, old->nsPerOp,
+                change, verdict.c_str());
+  }
+  return ok;
+}
+
+void usage() {
+  std::fprintf(stderr,
+               "usage: firmware_bench [--out FILE] [--baseline FILE] [--threshold PCT] "
+               "[--filter TEXT] [--rounds N] [--min-ms N]\n");
+  std::exit(2);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  std::string outPath;
+  std::string baselinePath;
+  std::string filter;
+  double thresholdPercent = 75;
+  int rounds = 9;
+  double minMs = 50;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--out" && hasValue) {
+      outPath = argv[++i];
+    } else if (arg == "--baseline" && hasValue) {
+      baselinePath = argv[++i];
+    } else if (arg == "--threshold" && hasValue) {
+      thresholdPercent = std::atof(argv[++i]);
+    } else if (arg == "--filter" && hasValue) {
+      filter = argv[++i];
+    } else if (arg == "--rounds" && hasValue) {
+      rounds = std::atoi(argv[++i]);
+    } else if (arg == "--min-ms" && hasValue) {
+      minMs = std::atof(argv[++i]);
+    } else {
+      usage();
+    }
+  }
+  if (rounds < 1) {
+    usage();
+  }
+  std::vector<Result> baseline;
+  if (!baselinePath.empty() && !readBaseline(baselinePath, baseline)) {
+    std::fprintf(stderr, "firmware_bench: cannot open %s\n", baselinePath.c_str());
+    return 2;
+  }
+
+  // Power on with the sensors on the trace
+  sim::HostBoard &board = sim::board();
+  board.reset();
+  SensorTrace trace;
+  board.setAnalogSource([&trace](uint8_t pin) { return trace.read(pin); });
+  setup();
+  Bench::drain();
+
+  auto idle = []() { command("STOP"); };
+  auto following = []() {
+    command("STOP");
+    command("GO 3");
+  };
+  auto tick = [&board](uint64_t us) { board.advance(us); };
+
+  Bench bench(rounds, minMs, filter);
+  std::printf("%-28s %10s %8s %9s %9s %9s\n", "case", "ns/op", "spread", "allocs", "bt_bytes",
+              "usb_bytes");
+
+  // loop(): one pass per op, 50 us apart, so the tasks run at their rates
+  bench.run("loop/idle", idle, [&]() {
+    tick(50);
+    loop();
+  });
+  bench.run("loop/following", following, [&]() {
+    tick(50);
+    loop();
+  });
+
+  // followLine(): one line task run per op on a fresh sensor sample
+  bench.run("followLine/weaving", following, [&]() {
+    tick(1000);
+    followLine();
+  });
+
+  // processCommand(): whole command lines, reply sent
+  bench.run("command/json_status", idle, commands({"{\"command\": \"status\"}"}));
+  bench.run("command/text_status", idle, commands({"STATUS"}));
+  bench.run("command/json_go_stop", idle,
+            commands({"{\"command\": \"go_to_table\", \"table_number\": 3}",
+                      "{\"command\": \"stop\"}"}));
+  bench.run("command/text_go_stop", idle, commands({"GO 3", "STOP"}));
+  bench.run("command/text_deliver_stop", idle, commands({"DELIVER 5 2 4", "STOP"}));
+  bench.run("command/json_tune_query", idle, commands({"{\"command\": \"tune\"}"}));
+  bench.run("command/text_hello", idle, commands({"HELLO"}));
+  bench.run("command/json_unknown", idle, commands({"{\"command\": \"dance\"}"}));
+
+  // sendStatus(): the status reply alone, as rendered for each link
+  auto status = []() {
+    Reply reply;
+    reply.beginObject();
+    sendStatus(reply);
+    reply.endObject();
+    Bench::rendered(reply.size());
+  };
+  bench.run("sendStatus/json_idle", idle, status);
+  bench.run("sendStatus/json_moving", following, status);
+  bench.run("sendStatus/binary", []() {
+    command("STOP");
+    binaryLink = true;
+  }, status);
+  binaryLink = false;
+
+  if (!outPath.empty()) {
+    writeResults(outPath, bench.results());
+  }
+  if (!baselinePath.empty() && !compare(bench.results(), baseline, thresholdPercent)) {
+    return 1;
+  }
+  return 0;
+}
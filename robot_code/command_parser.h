@@ -0,0 +1,415 @@
+// Smart Waiter Robot - Command Parser
+// Single-pass parser for the JSON and plain-text command forms. Works on a
+// fixed line buffer and never allocates, unlike the old String-based parser.
+//
+// Accepted forms:
+//   {"command": "go_to_table", "table_number": 3}     (JSON subset)
+//   {"command": "tune", "kp": 51, "speed": 220}
+//   GO3 / GO 3 / HOME / STOP / STATUS / HELLO 1       (text, case-insensitive)
+//   CALIBRATE / MARKER 3 4                            (table 3 at node 4)
+//   TUNE 51 0 1280 220                                (kp ki kd speed)
+//   {"command": "deliver", "tables": [5, 2, 4]} / DELIVER 5 2 4
+//   QUEUE / CLEAR                                     (list / empty the queue)
+//   {"command": "curve_speed", "speeds": [100, 90, 70, 50, 40]} / CURVE 100 90 70 50 40
+//   {"command": "metrics", "section": 1, "reset": 1} / METRICS 1 1  (timing)
+//   {"command": "subscribe", "period_ms": 200} / SUBSCRIBE 200     (0 stops)
+
+#ifndef COMMAND_PARSER_H
+#define COMMAND_PARSER_H
+
+#include "keyword_table.h"
+
+class __FlashStringHelper;
+
+enum CommandId {
+  CMD_NONE,
+  CMD_GO_TO_TABLE,
+  CMD_RETURN_HOME,
+  CMD_STOP,
+  CMD_STATUS,
+  CMD_HELLO,
+  CMD_TUNE,
+  CMD_CALIBRATE,
+  CMD_SET_MARKER,
+  CMD_DELIVER,
+  CMD_QUEUE,
+  CMD_CLEAR,
+  CMD_CURVE_SPEED,
+  CMD_METRICS,
+  CMD_SUBSCRIBE,
+  CMD_UNKNOWN
+};
+
+const unsigned char kMaxCommandArgs = 5;
+
+// A decoded command. args[] holds the numeric parameters in order
+// (args[0] is the table number for go_to_table, the protocol version for
+// hello; kp, ki, kd and speed for tune; table and node for set_marker; the
+// tables for deliver; the speed table for curve_speed; section and reset
+// for metrics; the period for subscribe). Bit i of argMask is set if args[i] was given, so
+// JSON commands can set some parameters and leave the rest.
+struct RobotCommand {
+  CommandId id;
+  unsigned char argCount;
+  unsigned char argMask;
+  int args[kMaxCommandArgs];
+};
+
+// A numeric parameter, clamped to what an int holds on AVR (binary frames
+// carry 32-bit varints; text and JSON numbers are clamped the same way)
+inline int commandArgument(long value) {
+  if (value > 32767) {
+    return 32767;
+  }
+  if (value < -32767) {
+    return -32767;
+  }
+  return (int)value;
+}
+
+// Command vocabulary. Both the JSON command names and the text keywords map
+// onto the same ids; add new commands here and the hash is rebuilt by the
+// compiler.
+constexpr KeywordEntry commandKeywords[] PROGMEM = {
+  {"go_to_table", CMD_GO_TO_TABLE},
+  {"return_home", CMD_RETURN_HOME},
+  {"stop",        CMD_STOP},
+  {"status",      CMD_STATUS},
+  {"hello",       CMD_HELLO},
+  {"tune",        CMD_TUNE},
+  {"calibrate",   CMD_CALIBRATE},
+  {"set_marker",  CMD_SET_MARKER},
+  {"deliver",     CMD_DELIVER},
+  {"queue",       CMD_QUEUE},
+  {"clear",       CMD_CLEAR},
+  {"curve_speed", CMD_CURVE_SPEED},
+  {"metrics",     CMD_METRICS},
+  {"subscribe",   CMD_SUBSCRIBE},
+  {"go",          CMD_GO_TO_TABLE},
+  {"home",        CMD_RETURN_HOME},
+  {"marker",      CMD_SET_MARKER},
+  {"curve",       CMD_CURVE_SPEED}
+};
+
+const unsigned int kCommandKeywordSlots = 32;
+static_assert(hasPerfectKeywordHash<kCommandKeywordSlots>(commandKeywords),
+              "No perfect hash for commandKeywords, increase kCommandKeywordSlots");
+constexpr KeywordSlots<kCommandKeywordSlots> commandKeywordSlots PROGMEM =
+    makeKeywordSlots<kCommandKeywordSlots>(commandKeywords);
+
+// JSON object keys the parser understands. Numeric keys map to the args[]
+// slot their value is stored in; a list field fills args[] from slot 0.
+const unsigned char kListField = 0xFD;
+const unsigned char kCommandNameField = 0xFE;
+const unsigned char kUnknownField = 0xFF;
+
+constexpr KeywordEntry commandFields[] PROGMEM = {
+  {"command",      kCommandNameField},
+  {"table_number", 0},
+  {"version",      0},
+  {"kp",           0},
+  {"ki",           1},
+  {"kd",           2},
+  {"speed",        3},
+  {"marker",       1},
+  {"tables",       kListField},
+  {"speeds",       kListField},
+  {"section",      0},
+  {"reset",        1},
+  {"period_ms",    0}
+};
+
+const unsigned int kCommandFieldSlots = 32;
+static_assert(hasPerfectKeywordHash<kCommandFieldSlots>(commandFields),
+              "No perfect hash for commandFields, increase kCommandFieldSlots");
+constexpr KeywordSlots<kCommandFieldSlots> commandFieldSlots PROGMEM =
+    makeKeywordSlots<kCommandFieldSlots>(commandFields);
+
+// Canonical (JSON) name of each command, indexed by CommandId. A table
+// rather than F() strings in commandName(): PSTR in an inline function
+// clashes with the sketch's own PROGMEM strings (section type conflict).
+const unsigned char kCommandNameSize = 12;
+const char commandNames[CMD_UNKNOWN][kCommandNameSize] PROGMEM = {
+  "", "go_to_table", "return_home", "stop", "status", "hello", "tune", "calibrate",
+  "set_marker", "deliver", "queue", "clear", "curve_speed", "metrics", "subscribe"
+};
+
+// Name of a command, used in replies. A flash string; off the AVR it can
+// be read as an ordinary one.
+inline const __FlashStringHelper *commandName(CommandId id) {
+  return reinterpret_cast<const __FlashStringHelper *>(
+      commandNames[id > CMD_NONE && id < CMD_UNKNOWN ? id : CMD_NONE]);
+}
+
+// Json and Text select the front-ends (firmware_config.h). A line in a
+// form that is compiled out is rejected as malformed.
+template <bool Json, bool Text>
+class BasicCommandParser {
+public:
+  // Parse one complete line. Returns false if the line is malformed;
+  // an unrecognised keyword parses successfully as CMD_UNKNOWN.
+  bool parse(const char *text, unsigned int length, RobotCommand &command) {
+    end = text + length;
+    pos = text;
+
+    command.id = CMD_NONE;
+    command.argCount = 0;
+    command.argMask = 0;
+    for (unsigned char i = 0; i < kMaxCommandArgs; i++) {
+      command.args[i] = 0;
+    }
+
+    skipSpace();
+    if (pos < end && *pos == '{') {
+      pos++;
+      return Json && parseObject(command);
+    }
+    return Text && parseText(command);
+  }
+
+private:
+  const char *end;
+  const char *pos;
+
+  static bool isDigit(char c) { return c >= '0' && c <= '9'; }
+  static bool isWordChar(char c) {
+    c = keywordLower(c);
+    return (c >= 'a' && c <= 'z') || c == '_';
+  }
+
+  void skipSpace() {
+    while (pos < end && (*pos == ' ' || *pos == '\t' || *pos == '\r' || *pos == '\n')) {
+      pos++;
+    }
+  }
+
+  bool consume(char c) {
+    skipSpace();
+    if (pos < end && *pos == c) {
+      pos++;
+      return true;
+    }
+    return false;
+  }
+
+  static CommandId lookupCommand(const char *start, unsigned int length) {
+    return (CommandId)findKeyword(commandKeywords, commandKeywordSlots, start, length, CMD_UNKNOWN);
+  }
+
+  static unsigned char lookupField(const char *start, unsigned int length) {
+    return findKeyword(commandFields, commandFieldSlots, start, length, kUnknownField);
+  }
+
+  // Signed decimal integer, clamped to the int range
+  bool parseInt(int &value) {
+    bool negative = false;
+    if (pos < end && (*pos == '-' || *pos == '+')) {
+      negative = *pos == '-';
+      pos++;
+    }
+    if (pos >= end || !isDigit(*pos)) {
+      return false;
+    }
+    long result = 0;
+    while (pos < end && isDigit(*pos)) {
+      if (result < 32767) {
+        result = result * 10 + (*pos - '0');
+      }
+      pos++;
+    }
+    value = commandArgument(negative ? -result : result);
+    return true;
+  }
+
+  static void addArg(RobotCommand &command, int value) {
+    if (command.argCount < kMaxCommandArgs) {
+      command.argMask |= 1 << command.argCount;
+      command.args[command.argCount++] = value;
+    }
+  }
+
+  // Quoted string; on success [start, start+length) is the raw contents
+  bool parseString(const char *&start, unsigned int &length) {
+    if (!consume('"')) {
+      return false;
+    }
+    start = pos;
+    while (pos < end && *pos != '"') {
+      if (*pos == '\\' && pos + 1 < end) {
+        pos++;
+      }
+      pos++;
+    }
+    if (pos >= end) {
+      return false;
+    }
+    length = (unsigned int)(pos - start);
+    pos++;
+    return true;
+  }
+
+  // Numeric value, optionally quoted ("table_number": "3" is accepted)
+  bool parseNumberValue(int &value) {
+    skipSpace();
+    if (pos < end && *pos == '"') {
+      const char *start;
+      unsigned int length;
+      const char *resume;
+      if (!parseString(start, length)) {
+        return false;
+      }
+      resume = pos;
+      pos = start;
+      const char *stringEnd = end;
+      end = start + length;
+      skipSpace();
+      bool ok = parseInt(value);
+      end = stringEnd;
+      pos = resume;
+      return ok;
+    }
+    return parseInt(value);
+  }
+
+  // Array of numbers into args[] from slot 0. A list too long for args[]
+  // parses as no arguments, so the command rejects it as invalid.
+  bool parseNumberList(RobotCommand &command) {
+    if (!consume('[')) {
+      return false;
+    }
+    command.argCount = 0;
+    command.argMask = 0;
+    if (consume(']')) {
+      return true;
+    }
+    bool tooLong = false;
+    while (true) {
+      int value;
+      if (!parseNumberValue(value)) {
+        return false;
+      }
+      tooLong = tooLong || command.argCount >= kMaxCommandArgs;
+      addArg(command, value);
+      if (consume(']')) {
+        break;
+      }
+      if (!consume(',')) {
+        return false;
+      }
+    }
+    if (tooLong) {
+      command.argCount = 0;
+      command.argMask = 0;
+    }
+    return true;
+  }
+
+  // Skip a value we do not care about (string, number, literal, array)
+  bool skipValue() {
+    skipSpace();
+    if (pos >= end) {
+      return false;
+    }
+    if (*pos == '"') {
+      const char *start;
+      unsigned int length;
+      return parseString(start, length);
+    }
+    if (*pos == '[') {
+      unsigned char depth = 0;
+      while (pos < end) {
+        if (*pos == '[') depth++;
+        if (*pos == ']' && --depth == 0) {
+          pos++;
+          return true;
+        }
+        pos++;
+      }
+      return false;
+    }
+    while (pos < end && *pos != ',' && *pos != '}') {
+      pos++;
+    }
+    return true;
+  }
+
+  bool parseObject(RobotCommand &command) {
+    if (consume('}')) {
+      return true;
+    }
+    while (true) {
+      const char *key;
+      unsigned int keyLength;
+      if (!parseString(key, keyLength) || !consume(':')) {
+        return false;
+      }
+
+      unsigned char field = lookupField(key, keyLength);
+      if (field == kCommandNameField) {
+        const char *value;
+        unsigned int valueLength;
+        if (!parseString(value, valueLength)) {
+          return false;
+        }
+        command.id = lookupCommand(value, valueLength);
+      }
+      else if (field == kListField) {
+        if (!parseNumberList(command)) {
+          return false;
+        }
+      }
+      else if (field < kMaxCommandArgs) {
+        int value;
+        if (!parseNumberValue(value)) {
+          return false;
+        }
+        command.args[field] = value;
+        command.argMask |= 1 << field;
+        if (command.argCount <= field) {
+          command.argCount = field + 1;
+        }
+      }
+      else if (!skipValue()) {
+        return false;
+      }
+
+      if (consume(',')) {
+        continue;
+      }
+      return consume('}');
+    }
+  }
+
+  bool parseText(RobotCommand &command) {
+    const char *start = pos;
+    while (pos < end && isWordChar(*pos)) {
+      pos++;
+    }
+    unsigned int length = (unsigned int)(pos - start);
+    if (length == 0) {
+      return false;
+    }
+    command.id = lookupCommand(start, length);
+
+    // Numeric arguments, either glued to the keyword (GO3) or separated by
+    // spaces or commas (GO 3)
+    while (true) {
+      while (pos < end && (*pos == ' ' || *pos == '\t' || *pos == ',')) {
+        pos++;
+      }
+      if (pos >= end) {
+        return true;
+      }
+      int value;
+      if (!parseInt(value)) {
+        return false;
+      }
+      addArg(command, value);
+    }
+  }
+};
+
+// Both front-ends, for the full firmware and host tools
+typedef BasicCommandParser<true, true> CommandParser;
+
+#endif
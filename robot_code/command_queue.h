@@ -0,0 +1,85 @@
+// Smart Waiter Robot - Command Queue
+// Fixed-capacity queue of motion commands waiting for the robot to finish
+// its current job, so a server can send the next jobs ahead instead of
+// polling for idle. Commands fall into three priorities:
+//   - immediate: queries and settings, answered at once and never queued
+//   - queued: anything that moves the robot, run one after another in the
+//     order received
+//   - preempt: STOP, which halts the robot at once and empties the queue
+
+#ifndef COMMAND_QUEUE_H
+#define COMMAND_QUEUE_H
+
+#include "command_parser.h"
+
+const unsigned char kCommandQueueSize = 6;
+
+enum CommandPriority {
+  PRIORITY_IMMEDIATE,
+  PRIORITY_QUEUED,
+  PRIORITY_PREEMPT
+};
+
+inline CommandPriority commandPriority(CommandId id) {
+  switch (id) {
+    case CMD_STOP:
+      return PRIORITY_PREEMPT;
+    case CMD_GO_TO_TABLE:
+    case CMD_RETURN_HOME:
+    case CMD_CALIBRATE:
+    case CMD_DELIVER:
+      return PRIORITY_QUEUED;
+    default:
+      return PRIORITY_IMMEDIATE;
+  }
+}
+
+// Ring buffer of whole commands, oldest first
+class CommandQueue {
+public:
+  CommandQueue() : head(0), count(0) {}
+
+  // Returns false if the queue is full
+  bool push(const RobotCommand &command) {
+    if (count >= kCommandQueueSize) {
+      return false;
+    }
+    entries[(head + count) % kCommandQueueSize] = command;
+    count++;
+    return true;
+  }
+
+  bool pop(RobotCommand &command) {
+    if (count == 0) {
+      return false;
+    }
+    command = entries[head];
+    head = (head + 1) % kCommandQueueSize;
+    count--;
+    return true;
+  }
+
+  // Drop everything; returns how many commands were dropped
+  unsigned char clear() {
+    unsigned char dropped = count;
+    head = 0;
+    count = 0;
+    return dropped;
+  }
+
+  unsigned char depth() const { return count; }
+  bool empty() const { return count == 0; }
+  bool full() const { return count >= kCommandQueueSize; }
+
+  // i = 0 is the next command to run
+  const RobotCommand &at(unsigned char i) const {
+    return entries[(head + i) % kCommandQueueSize];
+  }
+
+private:
+  RobotCommand entries[kCommandQueueSize];
+  unsigned char head;
+  unsigned char count;
+};
+
+#endif
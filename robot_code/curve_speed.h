@@ -0,0 +1,86 @@
+// Smart Waiter Robot - Curvature-Adaptive Speed
+// Estimates how sharply the line is bending from the recent history of the
+// line position: on a straight the line stays near the center sensor, in a
+// curve it sits off to one side. The estimate rises fast (a curve is
+// entered quickly) and falls slowly (so the robot does not speed up
+// mid-curve), and picks the cruise speed from a speed-vs-curvature table:
+// full speed on straights, slower the tighter the curve.
+
+#ifndef CURVE_SPEED_H
+#define CURVE_SPEED_H
+
+// Table points, at curvature 0, 250, 500, 750 and 1000
+const unsigned char kCurvePoints = 5;
+const int kCurveStep = 250;
+
+// Smoothing per update (1 kHz): new = old + (sample - old) / 2^shift
+const unsigned char kCurveRiseShift = 3;  // ~8 ms
+const unsigned char kCurveFallShift = 8;  // ~250 ms
+
+// Lowest speed the table may ask for, in percent of the cruise speed
+const unsigned char kMinCurveSpeedPercent = 10;
+
+class CurveSpeed {
+public:
+  CurveSpeed() : estimate(0) {
+    static const unsigned char defaults[kCurvePoints] = {100, 90, 70, 50, 40};
+    for (unsigned char i = 0; i < kCurvePoints; i++) {
+      percent[i] = defaults[i];
+    }
+  }
+
+  // Speed in percent of cruise at each table point. Returns false (and
+  // keeps the table) if a value is out of range.
+  bool setTable(const int *values, unsigned char count) {
+    if (count != kCurvePoints) {
+      return false;
+    }
+    for (unsigned char i = 0; i < kCurvePoints; i++) {
+      if (values[i] < kMinCurveSpeedPercent || values[i] > 100) {
+        return false;
+      }
+    }
+    for (unsigned char i = 0; i < kCurvePoints; i++) {
+      percent[i] = (unsigned char)values[i];
+    }
+    return true;
+  }
+
+  unsigned char tablePercent(unsigned char i) const { return percent[i]; }
+
+  // Straight ahead again, e.g. at the start of a journey
+  void reset() { estimate = 0; }
+
+  // One line position (-1000..1000)
+  void update(int linePosition) {
+    long sample = (long)(linePosition < 0 ? -linePosition : linePosition) << 4;
+    if (sample > estimate) {
+      estimate += (sample - estimate) >> kCurveRiseShift;
+    } else {
+      estimate -= (estimate - sample) >> kCurveFallShift;
+    }
+  }
+
+  // 0 (straight) to 1000 (line under an outer sensor)
+  int curvature() const {
+    long value = estimate >> 4;
+    return value > 1000 ? 1000 : (int)value;
+  }
+
+  // Cruise speed for the current curvature, interpolated from the table
+  long scale(long cruise) const {
+    int c = curvature();
+    unsigned char i = c / kCurveStep;
+    if (i >= kCurvePoints - 1) {
+      return cruise * percent[kCurvePoints - 1] / 100;
+    }
+    long p = percent[i] + (long)(percent[i + 1] - percent[i]) * (c - i * kCurveStep) / kCurveStep;
+    return cruise * p / 100;
+  }
+
+private:
+  long estimate; // Curvature with 4 fractional bits
+  unsigned char percent[kCurvePoints];
+};
+
+#endif
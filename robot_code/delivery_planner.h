@@ -0,0 +1,139 @@
+// Smart Waiter Robot - Multi-Stop Delivery Planner
+// Holds the stops of one delivery run (a tray for several tables) and puts
+// them in the cheapest visiting order for the layout: every order is tried,
+// with each leg costed by the route planner, ending with the trip home.
+// At most five stops, so that is 120 orders; partial orders already dearer
+// than the best complete one are cut short.
+//
+// The cost of a leg comes from the sketch, which knows the layout and the
+// stop map:
+//   long legCost(TrackPosition &position, unsigned char stop);
+// It returns the leg's length in mm (stop 0 = home) and moves position on
+// to the station where the robot would arrive, or -1 if the stop cannot be
+// reached; orders with such a leg are skipped.
+
+#ifndef DELIVERY_PLANNER_H
+#define DELIVERY_PLANNER_H
+
+#include "route_graph.h"
+
+const unsigned char kMaxDeliveryStops = 5;
+
+typedef long (*DeliveryLegCost)(TrackPosition &position, unsigned char stop);
+
+class DeliveryPlanner {
+public:
+  DeliveryPlanner() { clear(); }
+
+  void clear() {
+    count = 0;
+    next = 0;
+  }
+
+  // Tables 1-5, each at most once
+  static bool validTables(const int *tables, unsigned char tableCount) {
+    if (tableCount == 0 || tableCount > kMaxDeliveryStops) {
+      return false;
+    }
+    for (unsigned char i = 0; i < tableCount; i++) {
+      if (tables[i] < 1 || tables[i] > 5) {
+        return false;
+      }
+      for (unsigned char j = 0; j < i; j++) {
+        if (tables[j] == tables[i]) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  // Returns false (and keeps the current run) if the list is not valid
+  bool begin(const int *tables, unsigned char tableCount) {
+    if (!validTables(tables, tableCount)) {
+      return false;
+    }
+    for (unsigned char i = 0; i < tableCount; i++) {
+      stops[i] = (unsigned char)tables[i];
+    }
+    count = tableCount;
+    next = 0;
+    return true;
+  }
+
+  // Reorder the stops for the shortest run from `start` through every stop
+  // and back home. Returns the run's length in mm, or -1 if no order
+  // reaches every stop.
+  long optimize(const TrackPosition &start, DeliveryLegCost legCost) {
+    cost = legCost;
+    bestMm = -1;
+    for (unsigned char i = 0; i < count; i++) {
+      order[i] = stops[i];
+    }
+    search(0, start, 0);
+    return bestMm;
+  }
+
+  bool active() const { return next < count; }
+
+  // Stop to head for, or 0 (home) once every stop has been visited
+  unsigned char nextStop() const { return active() ? stops[next] : 0; }
+
+  // The robot has left the current stop
+  void advance() {
+    if (next < count) {
+      next++;
+    }
+  }
+
+  unsigned char stopCount() const { return count; }
+  unsigned char stopIndex() const { return next; } // 0-based, of nextStop()
+  unsigned char stop(unsigned char i) const { return stops[i]; }
+
+private:
+  unsigned char stops[kMaxDeliveryStops];  // Visiting order
+  unsigned char order[kMaxDeliveryStops];  // Order being tried
+  unsigned char count;
+  unsigned char next;
+  DeliveryLegCost cost;
+  long bestMm;
+
+  // Stops before `depth` are placed; try each remaining one next
+  void search(unsigned char depth, const TrackPosition &position, long soFarMm) {
+    if (bestMm >= 0 && soFarMm >= bestMm) {
+      return;
+    }
+    if (depth == count) {
+      TrackPosition end = position;
+      long homeMm = cost(end, 0);
+      if (homeMm < 0) {
+        return;
+      }
+      long totalMm = soFarMm + homeMm;
+      if (bestMm < 0 || totalMm < bestMm) {
+        bestMm = totalMm;
+        for (unsigned char i = 0; i < count; i++) {
+          stops[i] = order[i];
+        }
+      }
+      return;
+    }
+    for (unsigned char i = depth; i < count; i++) {
+      swap(depth, i);
+      TrackPosition arrival = position;
+      long legMm = cost(arrival, order[depth]);
+      if (legMm >= 0) {
+        search(depth + 1, arrival, soFarMm + legMm);
+      }
+      swap(depth, i);
+    }
+  }
+
+  void swap(unsigned char a, unsigned char b) {
+    unsigned char stop = order[a];
+    order[a] = order[b];
+    order[b] = stop;
+  }
+};
+
+#endif
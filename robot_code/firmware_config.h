@@ -0,0 +1,52 @@
+// Smart Waiter Robot - Firmware Variants
+// The one sketch builds in several configurations. Each variant is a
+// policy of compile-time switches; code for a front-end or feature that is
+// switched off sits behind `if (Firmware::...)` and is removed by the
+// compiler, together with the functions and globals only it uses.
+//
+// Pick a variant with WAITER_VARIANT (the full firmware by default), e.g.
+// with arduino-cli:
+//   --build-property "compiler.cpp.extra_flags=-DWAITER_VARIANT=SimpleFirmware"
+
+#ifndef FIRMWARE_CONFIG_H
+#define FIRMWARE_CONFIG_H
+
+// Everything: the app, gateways and bench testing over Bluetooth
+struct FullFirmware {
+  static const bool jsonCommands = true;   // {"command": "go_to_table", ...}
+  static const bool textCommands = true;   // GO3, STATUS, ...
+  static const bool binaryFrames = true;   // robot_protocol.h frames
+  static const bool usbCommands = false;   // Commands on USB serial too
+  static const bool telemetry = true;      // SUBSCRIBE
+  static const bool metrics = true;        // METRICS and the task timings
+};
+
+// The Flutter app only: JSON commands over Bluetooth
+struct AppFirmware {
+  static const bool jsonCommands = true;
+  static const bool textCommands = false;
+  static const bool binaryFrames = false;
+  static const bool usbCommands = false;
+  static const bool telemetry = false;
+  static const bool metrics = false;
+};
+
+// Bench testing from a terminal or the Serial Monitor: text commands on
+// Bluetooth and USB serial, nothing optional. Replaces the old
+// smart_waiter_robot_simple.ino.
+struct SimpleFirmware {
+  static const bool jsonCommands = false;
+  static const bool textCommands = true;
+  static const bool binaryFrames = false;
+  static const bool usbCommands = true;
+  static const bool telemetry = false;
+  static const bool metrics = false;
+};
+
+#ifndef WAITER_VARIANT
+#define WAITER_VARIANT FullFirmware
+#endif
+
+typedef WAITER_VARIANT Firmware;
+
+#endif
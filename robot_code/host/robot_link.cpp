@@ -0,0 +1,219 @@
+// Smart Waiter Robot - Host-side Link Library
+
+#include "robot_link.h"
+
+#include "../command_parser.h"
+#include "../robot_protocol.h"
+#include "../telemetry_stream.h"
+
+namespace robot_link {
+
+std::vector<uint8_t> encodeFrame(const Message &message) {
+  FrameBuilder builder;
+  builder.begin(message.opcode);
+  for (int32_t value : message.values) {
+    builder.add(value);
+  }
+  std::vector<uint8_t> out(kMaxEncodedFrame);
+  out.resize(builder.finish(out.data()));
+  return out;
+}
+
+bool decodeFrame(const uint8_t *data, size_t length, Message &message) {
+  std::vector<uint8_t> scratch(data, data + length);
+  FrameReader reader;
+  if (!reader.open(scratch.data(), (unsigned int)scratch.size())) {
+    return false;
+  }
+  message.opcode = reader.opcode();
+  message.values.clear();
+  long value;
+  while (!reader.atEnd()) {
+    if (!reader.next(value)) {
+      return false;
+    }
+    message.values.push_back((int32_t)value);
+  }
+  return true;
+}
+
+Message hello() { return Message{CMD_HELLO, {kProtocolVersion}}; }
+Message goToTable(int table) { return Message{CMD_GO_TO_TABLE, {table}}; }
+Message returnHome() { return Message{CMD_RETURN_HOME, {}}; }
+Message stop() { return Message{CMD_STOP, {}}; }
+Message status() { return Message{CMD_STATUS, {}}; }
+Message tune(int kp, int ki, int kd, int speed) { return Message{CMD_TUNE, {kp, ki, kd, speed}}; }
+Message calibrate() { return Message{CMD_CALIBRATE, {}}; }
+Message setMarker(int stop, int marker) { return Message{CMD_SET_MARKER, {stop, marker}}; }
+Message deliver(const std::vector<int32_t> &tables) { return Message{CMD_DELIVER, tables}; }
+Message queue() { return Message{CMD_QUEUE, {}}; }
+Message clearQueue() { return Message{CMD_CLEAR, {}}; }
+Message curveSpeed(const std::vector<int32_t> &speeds) { return Message{CMD_CURVE_SPEED, speeds}; }
+Message metrics(int section, bool reset) { return Message{CMD_METRICS, {section, reset ? 1 : 0}}; }
+Message subscribe(int periodMs) { return Message{CMD_SUBSCRIBE, {periodMs}}; }
+
+void LinkDecoder::feed(const uint8_t *data, size_t length) {
+  if (pos_ > 0 && pos_ == buffer_.size()) {
+    buffer_.clear();
+    pos_ = 0;
+  }
+  buffer_.insert(buffer_.end(), data, data + length);
+}
+
+LinkDecoder::Kind LinkDecoder::next(Message &message, std::string &text) {
+  while (pos_ < buffer_.size()) {
+    if (buffer_[pos_] == kFrameDelimiter) {
+      // Binary frame: runs to the next delimiter
+      size_t start = pos_ + 1;
+      size_t end = start;
+      while (end < buffer_.size() && buffer_[end] != kFrameDelimiter) {
+        end++;
+      }
+      if (end == buffer_.size()) {
+        return Kind::None;
+      }
+      pos_ = end + 1;
+      if (end == start) {
+        continue;  // Empty frame, used to resynchronise
+      }
+      return decodeFrame(&buffer_[start], end - start, message) ? Kind::Frame : Kind::BadFrame;
+    }
+
+    size_t end = pos_;
+    while (end < buffer_.size() && buffer_[end] != '\n' && buffer_[end] != kFrameDelimiter) {
+      end++;
+    }
+    if (end == buffer_.size()) {
+      return Kind::None;
+    }
+    text.assign(buffer_.begin() + pos_, buffer_.begin() + end);
+    if (!text.empty() && text.back() == '\r') {
+      text.pop_back();
+    }
+    pos_ = buffer_[end] == '\n' ? end + 1 : end;
+    if (!text.empty()) {
+      return Kind::Text;
+    }
+  }
+  return Kind::None;
+}
+
+namespace {
+
+const char *eventName(int32_t event) {
+  switch (event) {
+    case EVENT_MOVING: return "moving";
+    case EVENT_RETURNING: return "returning";
+    case EVENT_STOPPED: return "stopped";
+    case EVENT_ARRIVED: return "arrived";
+    case EVENT_HOME: return "home";
+    case EVENT_CALIBRATING: return "calibrating";
+    case EVENT_CALIBRATED: return "calibrated";
+    case EVENT_DEPARTED: return "departed";
+    case EVENT_QUEUED: return "queued";
+    default: return "unknown";
+  }
+}
+
+// The firmware's command names are flash strings, ordinary memory here
+std::string commandText(int32_t command) {
+  return reinterpret_cast<const char *>(commandName((CommandId)command));
+}
+
+int32_t valueAt(const Message &message, size_t index) {
+  return index < message.values.size() ? message.values[index] : 0;
+}
+
+}  // namespace
+
+bool TelemetryDecoder::apply(const Message &message, std::vector<int32_t> &values) {
+  if (message.opcode != REPLY_TELEMETRY || message.values.size() != 1 + (size_t)kTelemetryFields) {
+    nextSequence_ = -1;
+    return false;
+  }
+  int sequence = message.values[0] >> 1;
+  bool key = message.values[0] & 1;
+  if (!key && sequence != nextSequence_) {
+    nextSequence_ = -1;
+    return false;
+  }
+  values_.resize(kTelemetryFields);
+  for (size_t i = 0; i < kTelemetryFields; i++) {
+    values_[i] = key ? message.values[i + 1] : values_[i] + message.values[i + 1];
+  }
+  nextSequence_ = (sequence + 1) % kTelemetrySequences;
+  values = values_;
+  return true;
+}
+
+const char *telemetryFieldName(size_t field) {
+  static const char *const names[kTelemetryFields] = {
+    "sensor_left", "sensor_center", "sensor_right", "line_position", "left_pwm",
+    "right_pwm", "state", "target_table", "progress", "loop_us"
+  };
+  return field < kTelemetryFields ? names[field] : "";
+}
+
+std::string describe(const Message &message) {
+  switch (message.opcode) {
+    case REPLY_ACK:
+      return "ack command=" + commandText(valueAt(message, 0)) +
+             " result=" + std::to_string(valueAt(message, 1));
+    case REPLY_HELLO:
+      return "hello protocol=" + std::to_string(valueAt(message, 0)) +
+             " caps=" + std::to_string(valueAt(message, 1));
+    case REPLY_STATUS:
+      return "status state=" + std::to_string(valueAt(message, 0)) +
+             " current_table=" + std::to_string(valueAt(message, 1)) +
+             " target_table=" + std::to_string(valueAt(message, 2)) +
+             " is_at_home=" + std::to_string(valueAt(message, 3));
+    case REPLY_EVENT:
+      return std::string("event ") + eventName(valueAt(message, 0)) +
+             " table=" + std::to_string(valueAt(message, 1));
+    case REPLY_ERROR:
+      return "error result=" + std::to_string(valueAt(message, 0));
+    case REPLY_QUEUE: {
+      std::string text = "queue depth=" + std::to_string(valueAt(message, 0));
+      for (size_t i = 1; i + 1 < message.values.size(); i += 2) {
+        text += " " + commandText(message.values[i]) + "(" +
+                std::to_string(message.values[i + 1]) + ")";
+      }
+      return text;
+    }
+    case REPLY_TELEMETRY: {
+      std::string text = "telemetry seq=" + std::to_string(valueAt(message, 0) >> 1) +
+                         ((valueAt(message, 0) & 1) ? " key" : " delta");
+      for (size_t i = 1; i < message.values.size(); i++) {
+        text += " " + std::to_string(message.values[i]);
+      }
+      return text;
+    }
+    case REPLY_METRICS: {
+      std::string text = "metrics section=" + std::to_string(valueAt(message, 0));
+      if (valueAt(message, 0) == 0) {
+        for (size_t i = 1; i + 1 < message.values.size(); i += 2) {
+          text += " " + std::to_string(message.values[i]) + "/" + std::to_string(message.values[i + 1]);
+        }
+        return text;
+      }
+      text += " count=" + std::to_string(valueAt(message, 1)) +
+              " min=" + std::to_string(valueAt(message, 2)) +
+              " mean=" + std::to_string(valueAt(message, 3)) +
+              " max=" + std::to_string(valueAt(message, 4)) +
+              " misses=" + std::to_string(valueAt(message, 5)) + " hist=";
+      for (size_t i = 6; i < message.values.size(); i++) {
+        text += (i > 6 ? "," : "") + std::to_string(message.values[i]);
+      }
+      return text;
+    }
+    default: {
+      std::string text = "opcode=" + std::to_string(message.opcode);
+      for (int32_t value : message.values) {
+        text += " " + std::to_string(value);
+      }
+      return text;
+    }
+  }
+}
+
+}  // namespace robot_link
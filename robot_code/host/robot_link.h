@@ -0,0 +1,83 @@
+// Smart Waiter Robot - Host-side Link Library
+// Encodes commands for, and decodes replies from, the robot's binary frame
+// protocol (robot_protocol.h) on a gateway or test machine. Text/JSON lines
+// that share the link are passed through unchanged.
+
+#ifndef ROBOT_LINK_H
+#define ROBOT_LINK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace robot_link {
+
+// One decoded frame: opcode plus its integer values
+struct Message {
+  uint8_t opcode = 0;
+  std::vector<int32_t> values;
+};
+
+// Encode a message as a complete frame, including both 0x00 delimiters
+std::vector<uint8_t> encodeFrame(const Message &message);
+
+// Decode a COBS block (the bytes between delimiters). Returns false if the
+// block is malformed or fails its CRC.
+bool decodeFrame(const uint8_t *data, size_t length, Message &message);
+
+// Request builders (opcode = firmware CommandId)
+Message hello();
+Message goToTable(int table);
+Message returnHome();
+Message stop();
+Message status();
+Message tune(int kp, int ki, int kd, int speed);
+Message calibrate();
+Message setMarker(int stop, int marker);
+Message deliver(const std::vector<int32_t> &tables);
+Message queue();
+Message clearQueue();
+Message curveSpeed(const std::vector<int32_t> &speeds); // Empty to keep the table
+Message metrics(int section, bool reset);             // Section 0 is the summary
+Message subscribe(int periodMs);                      // 0 stops the stream
+
+// Splits an incoming byte stream into binary frames and text lines
+class LinkDecoder {
+public:
+  enum class Kind { None, Frame, Text, BadFrame };
+
+  void feed(const uint8_t *data, size_t length);
+
+  // Pop the next complete item. For Kind::Frame, message is filled in; for
+  // Kind::Text, text holds the line without its terminator.
+  Kind next(Message &message, std::string &text);
+
+private:
+  std::vector<uint8_t> buffer_;
+  size_t pos_ = 0;
+};
+
+// Rebuilds the telemetry values from key and delta frames
+// (telemetry_stream.h)
+class TelemetryDecoder {
+public:
+  // Apply a telemetry message. Returns true with values filled in for a key
+  // frame, or a delta frame that follows the previous frame; false while
+  // waiting for a key frame after a lost or bad frame.
+  bool apply(const Message &message, std::vector<int32_t> &values);
+
+private:
+  std::vector<int32_t> values_;
+  int nextSequence_ = -1;
+};
+
+// Name of telemetry field i, e.g. "line_position"
+const char *telemetryFieldName(size_t field);
+
+// Readable form of a reply, e.g. "event arrived table=3"
+std::string describe(const Message &message);
+
+}  // namespace robot_link
+
+#endif
@@ -0,0 +1,311 @@
+// Smart Waiter Robot - Link Library Tests
+// Checks the frame encoding shared with the firmware (robot_protocol.h)
+// and the host-side decoders in robot_link.h, and that a reply that runs out
+// of room is still a whole line (reply_builder.h). Run by ctest; prints each
+// failed check and exits 1 if there was one.
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "robot_link.h"
+
+#include "../command_parser.h"
+#include "../reply_builder.h"
+#include "../robot_protocol.h"
+#include "../telemetry_stream.h"
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(condition)                                                      \
+  do {                                                                        \
+    if (!(condition)) {                                                       \
+      std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+      failures++;                                                             \
+    }                                                                         \
+  } while (0)
+
+using robot_link::LinkDecoder;
+using robot_link::Message;
+
+bool cobsRoundTrip(const std::vector<uint8_t> &payload) {
+  std::vector<uint8_t> encoded(payload.size() + payload.size() / 254 + 1);
+  unsigned int length = cobsEncode(payload.data(), (unsigned int)payload.size(), encoded.data());
+  if (length > encoded.size()) {
+    return false;
+  }
+  encoded.resize(length);
+  for (uint8_t byte : encoded) {
+    if (byte == 0) {
+      return false;
+    }
+  }
+  std::vector<uint8_t> decoded(encoded.size());
+  int decodedLength = cobsDecode(encoded.data(), (unsigned int)encoded.size(), decoded.data());
+  decoded.resize(decodedLength < 0 ? 0 : (size_t)decodedLength);
+  return decodedLength >= 0 && decoded == payload;
+}
+
+void testCobs() {
+  CHECK(cobsRoundTrip({}));
+  CHECK(cobsRoundTrip({0x00}));
+  CHECK(cobsRoundTrip({0x00, 0x00, 0x00}));
+  CHECK(cobsRoundTrip({0x11, 0x00, 0x22, 0x00}));
+  CHECK(cobsRoundTrip({0x00, 0x11, 0x22, 0x33}));
+
+  // Runs of non-zero bytes around the 254-byte block limit
+  for (size_t run : {253u, 254u, 255u, 508u, 509u}) {
+    std::vector<uint8_t> payload(run);
+    for (size_t i = 0; i < run; i++) {
+      payload[i] = (uint8_t)(1 + i % 255);
+    }
+    CHECK(cobsRoundTrip(payload));
+    payload.push_back(0x00);
+    CHECK(cobsRoundTrip(payload));
+    payload.insert(payload.begin(), 0x00);
+    CHECK(cobsRoundTrip(payload));
+  }
+
+  // A code byte that points past the end is malformed
+  uint8_t truncated[] = {0x05, 0x11, 0x22};
+  uint8_t out[8];
+  CHECK(cobsDecode(truncated, sizeof(truncated), out) == -1);
+}
+
+void testCrc() {
+  // CRC-16/CCITT-FALSE check value
+  const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+  CHECK(crc16(check, sizeof(check)) == 0x29B1);
+
+  Message sent{REPLY_EVENT, {EVENT_ARRIVED, 3}};
+  std::vector<uint8_t> frame = robot_link::encodeFrame(sent);
+  CHECK(frame.front() == 0x00 && frame.back() == 0x00);
+
+  Message received;
+  CHECK(robot_link::decodeFrame(&frame[1], frame.size() - 2, received));
+  CHECK(received.opcode == sent.opcode && received.values == sent.values);
+
+  // Any single changed byte inside the block is caught
+  for (size_t i = 1; i + 1 < frame.size(); i++) {
+    std::vector<uint8_t> corrupt = frame;
+    corrupt[i] ^= 0x10;
+    if (corrupt[i] == 0x00) {
+      continue;
+    }
+    CHECK(!robot_link::decodeFrame(&corrupt[1], corrupt.size() - 2, received));
+  }
+}
+
+size_t encodedValueBytes(int32_t value) {
+  // Opcode + varint + CRC, COBS adds one byte at this size
+  return robot_link::encodeFrame(Message{REPLY_ACK, {value}}).size() - 2 - 1 - 1 - 2;
+}
+
+void testVarints() {
+  const int32_t limits[] = {0, 1, -1, 63, -64, 64, -65, 8191, -8192, 8192,
+                            INT32_MAX, INT32_MIN, INT32_MAX - 1, INT32_MIN + 1};
+  Message sent{REPLY_STATUS, {}};
+  for (int32_t value : limits) {
+    sent.values.push_back(value);
+  }
+  std::vector<uint8_t> frame = robot_link::encodeFrame(sent);
+  Message received;
+  CHECK(robot_link::decodeFrame(&frame[1], frame.size() - 2, received));
+  CHECK(received.values == sent.values);
+
+  CHECK(encodedValueBytes(63) == 1);
+  CHECK(encodedValueBytes(-64) == 1);
+  CHECK(encodedValueBytes(64) == 2);
+  CHECK(encodedValueBytes(-65) == 2);
+  CHECK(encodedValueBytes(INT32_MAX) == 5);
+  CHECK(encodedValueBytes(INT32_MIN) == 5);
+
+  // A sixth continuation byte is rejected, not wrapped
+  std::vector<uint8_t> payload = {REPLY_ACK, 0x80, 0x80, 0x80, 0x80, 0x80, 0x01};
+  unsigned short crc = crc16(payload.data(), (unsigned int)payload.size());
+  payload.push_back(crc & 0xFF);
+  payload.push_back(crc >> 8);
+  std::vector<uint8_t> block(payload.size() + 2);
+  block.resize(cobsEncode(payload.data(), (unsigned int)payload.size(), block.data()));
+  CHECK(!robot_link::decodeFrame(block.data(), block.size(), received));
+}
+
+void testLinkDecoder() {
+  std::vector<uint8_t> stream;
+  auto addText = [&](const std::string &text) { stream.insert(stream.end(), text.begin(), text.end()); };
+  auto addFrame = [&](const Message &message) {
+    std::vector<uint8_t> frame = robot_link::encodeFrame(message);
+    stream.insert(stream.end(), frame.begin(), frame.end());
+  };
+  addText("{\"status\":\"hello\"}\r\n");
+  addFrame(Message{REPLY_EVENT, {EVENT_MOVING, 2}});
+  stream.push_back(0x00);  // Empty frame, sent to resynchronise
+  stream.push_back(0x00);
+  addText("Received bad frame\n");
+  addFrame(Message{REPLY_HELLO, {kProtocolVersion, CAP_JSON | CAP_BINARY}});
+  addFrame(Message{REPLY_ACK, {CMD_STOP, 0}});
+  std::vector<uint8_t> bad = robot_link::encodeFrame(Message{REPLY_ACK, {1}});
+  bad[2] ^= 0x01;
+  stream.insert(stream.end(), bad.begin(), bad.end());
+  addText("tail\n");
+
+  // Fed a byte at a time, so every item is split across feeds
+  LinkDecoder decoder;
+  std::vector<std::string> items;
+  Message message;
+  std::string text;
+  for (uint8_t byte : stream) {
+    decoder.feed(&byte, 1);
+    LinkDecoder::Kind kind;
+    while ((kind = decoder.next(message, text)) != LinkDecoder::Kind::None) {
+      if (kind == LinkDecoder::Kind::Text) {
+        items.push_back("text " + text);
+      } else if (kind == LinkDecoder::Kind::Frame) {
+        items.push_back(robot_link::describe(message));
+      } else {
+        items.push_back("bad frame");
+      }
+    }
+  }
+
+  std::vector<std::string> expected = {
+    "text {\"status\":\"hello\"}",
+    "event moving table=2",
+    "text Received bad frame",
+    "hello protocol=1 caps=5",
+    "ack command=stop result=0",
+    "bad frame",
+    "text tail",
+  };
+  CHECK(items.size() == expected.size());
+  for (size_t i = 0; i < items.size() && i < expected.size(); i++) {
+    if (items[i] != expected[i]) {
+      std::printf("item %zu: \"%s\", expected \"%s\"\n", i, items[i].c_str(), expected[i].c_str());
+      failures++;
+    }
+  }
+}
+
+// Frames from the firmware's encoder, decoded as the host receives them
+std::vector<Message> telemetryFrames(int count) {
+  TelemetryStream stream;
+  stream.subscribe(kTelemetryDefaultPeriodMs, 0);
+  std::vector<Message> frames;
+  for (int i = 0; i < count; i++) {
+    long values[kTelemetryFields];
+    for (int field = 0; field < kTelemetryFields; field++) {
+      values[field] = field * 100 + i * (field % 3 - 1);
+    }
+    FrameBuilder builder;
+    stream.encode(values, builder);
+    unsigned char out[kMaxEncodedFrame];
+    unsigned int length = builder.finish(out);
+    Message message;
+    robot_link::decodeFrame(out + 1, length - 2, message);
+    frames.push_back(message);
+  }
+  return frames;
+}
+
+void testTelemetryDecoder() {
+  std::vector<Message> frames = telemetryFrames(40);
+  robot_link::TelemetryDecoder decoder;
+  std::vector<int32_t> values;
+
+  // In order, every frame gives the values the robot encoded
+  for (size_t i = 0; i < frames.size(); i++) {
+    CHECK(decoder.apply(frames[i], values));
+    CHECK(values.size() == (size_t)kTelemetryFields);
+    CHECK(values.size() > 4 && values[4] == 400);
+    CHECK(values.size() > 5 && values[5] == 500 + (int32_t)i);
+  }
+
+  // Frame 3 is lost: deltas are ignored until the key frame at 16
+  robot_link::TelemetryDecoder gapped;
+  for (size_t i = 0; i < 20; i++) {
+    if (i == 3) {
+      continue;
+    }
+    bool applied = gapped.apply(frames[i], values);
+    CHECK(applied == (i < 3 || i >= 16));
+    if (applied) {
+      CHECK(values[5] == 500 + (int32_t)i);
+    }
+  }
+
+  // A frame that is not telemetry resets the decoder too
+  robot_link::TelemetryDecoder reset;
+  CHECK(reset.apply(frames[0], values));
+  CHECK(!reset.apply(Message{REPLY_ACK, {0, 0}}, values));
+  CHECK(!reset.apply(frames[1], values));
+}
+
+// Frame arguments are clamped to an int like text ones, not wrapped
+// (65539 would be 3 on AVR)
+void testArgumentClamp() {
+  std::vector<uint8_t> frame = robot_link::encodeFrame(
+      Message{CMD_GO_TO_TABLE, {65539, -70000, 32767, -32767, 3}});
+  FrameReader reader;
+  CHECK(reader.open(&frame[1], (unsigned int)frame.size() - 2));
+  std::vector<int> args;
+  long value;
+  while (reader.next(value)) {
+    args.push_back(commandArgument(value));
+  }
+  CHECK((args == std::vector<int>{32767, -32767, 32767, -32767, 3}));
+
+  const char line[] = "GO 65539";
+  RobotCommand command;
+  CommandParser parser;
+  CHECK(parser.parse(line, sizeof(line) - 1, command));
+  CHECK(command.args[0] == 32767);
+}
+
+// A reply that runs out of room is still one complete JSON line
+void testReplyTruncation() {
+  const unsigned int capacity = kReplyTailBytes + kMaxEncodedFrame + 1;
+  std::string filler(kMaxEncodedFrame - 20, 'x');
+
+  ReplyBuilder<capacity> fits;
+  fits.beginObject();
+  fits.field("a", filler.c_str());
+  fits.endObject();
+  CHECK(!fits.wasTruncated());
+
+  ReplyBuilder<capacity> reply;
+  reply.beginObject();
+  reply.field("a", filler.c_str());
+  reply.field("long_enough_to_overflow", 1234567L);
+  reply.field("b", 1);
+  reply.endObject();
+  std::string line(reply.data(), reply.size());
+  CHECK(reply.wasTruncated());
+  CHECK(line == "{\"a\":\"" + filler + "\",\"truncated\":true}\r\n");
+
+  ReplyBuilder<capacity> first;
+  first.beginObject();
+  first.field("a", (filler + filler).c_str());
+  first.endObject();
+  CHECK(std::string(first.data(), first.size()) == "{\"truncated\":true}\r\n");
+}
+
+}  // namespace
+
+int main() {
+  testCobs();
+  testCrc();
+  testVarints();
+  testLinkDecoder();
+  testTelemetryDecoder();
+  testReplyTruncation();
+  testArgumentClamp();
+  if (failures) {
+    std::printf("%d check(s) failed\n", failures);
+    return 1;
+  }
+  std::printf("robot_link: all checks passed\n");
+  return 0;
+}
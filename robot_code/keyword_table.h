@@ -0,0 +1,183 @@
+// Smart Waiter Robot - Compile-time Keyword Tables
+// Keyword lists are declared as constexpr arrays kept in flash (PROGMEM).
+// A perfect hash seed and the slot index are computed by the compiler, so a
+// lookup is one pass over the input plus a single confirming compare.
+//
+// The constexpr functions below are written for C++11 (the Arduino AVR
+// toolchain default): single return statements, and divide-and-conquer
+// recursion to stay well inside the compiler's constexpr depth limit.
+
+#ifndef KEYWORD_TABLE_H
+#define KEYWORD_TABLE_H
+
+#ifdef __AVR__
+#include <avr/pgmspace.h>
+#endif
+
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+
+#ifndef pgm_read_byte
+#define pgm_read_byte(address) (*(const unsigned char *)(address))
+#endif
+
+#ifndef pgm_read_word
+#define pgm_read_word(address) (*(const unsigned short *)(address))
+#endif
+
+const unsigned char kMaxKeywordLength = 15;
+const unsigned char kNoKeyword = 0xFF;
+const unsigned int kKeywordSeedLimit = 1024;
+const unsigned int kKeywordSeedChunk = 32;
+
+struct KeywordEntry {
+  char name[kMaxKeywordLength + 1]; // Lower case
+  unsigned char value;
+};
+
+// Slot index: keyword position for each hash slot, or kNoKeyword
+template <unsigned int Slots>
+struct KeywordSlots {
+  unsigned short seed;
+  unsigned char shift;
+  unsigned char slot[Slots];
+};
+
+// 16-bit multiplicative hash over lower-cased characters. Only the top
+// bits are used for the slot, the seed is searched for at compile time.
+constexpr unsigned int keywordHashStep(unsigned int hash, char c) {
+  return ((hash ^ (unsigned char)c) * 0x0193u) & 0xFFFFu;
+}
+
+constexpr unsigned int keywordHash(const char *text, unsigned int seed) {
+  return *text == '\0' ? seed : keywordHash(text + 1, keywordHashStep(seed, *text));
+}
+
+constexpr unsigned char slotShift(unsigned int slots, unsigned char shift = 16) {
+  return slots <= 1 ? shift : slotShift(slots / 2, shift - 1);
+}
+
+template <unsigned int Count>
+constexpr unsigned int keywordSlot(const KeywordEntry (&table)[Count], unsigned int index,
+                                   unsigned int seed, unsigned char shift) {
+  return keywordHash(table[index].name, seed) >> shift;
+}
+
+// True if keyword i does not share a slot with any keyword in [lo, hi)
+template <unsigned int Count>
+constexpr bool slotUnique(const KeywordEntry (&table)[Count], unsigned int i, unsigned int lo,
+                          unsigned int hi, unsigned int seed, unsigned char shift) {
+  return lo >= hi ? true
+       : hi - lo == 1 ? keywordSlot(table, i, seed, shift) != keywordSlot(table, lo, seed, shift)
+       : slotUnique(table, i, lo, (lo + hi) / 2, seed, shift) &&
+         slotUnique(table, i, (lo + hi) / 2, hi, seed, shift);
+}
+
+// True if every keyword in [lo, hi) has a slot of its own
+template <unsigned int Count>
+constexpr bool slotsPerfect(const KeywordEntry (&table)[Count], unsigned int lo, unsigned int hi,
+                            unsigned int seed, unsigned char shift) {
+  return lo >= hi ? true
+       : hi - lo == 1 ? slotUnique(table, lo, lo + 1, Count, seed, shift)
+       : slotsPerfect(table, lo, (lo + hi) / 2, seed, shift) &&
+         slotsPerfect(table, (lo + hi) / 2, hi, seed, shift);
+}
+
+constexpr unsigned int firstKeywordSeed(unsigned int a, unsigned int b) {
+  return a != kKeywordSeedLimit ? a : b;
+}
+
+// First seed in [lo, hi) giving a perfect hash, or kKeywordSeedLimit
+template <unsigned int Count>
+constexpr unsigned int findSeedInChunk(const KeywordEntry (&table)[Count], unsigned int lo,
+                                       unsigned int hi, unsigned char shift) {
+  return hi - lo == 1
+       ? (slotsPerfect(table, 0, Count, lo, shift) ? lo : kKeywordSeedLimit)
+       : firstKeywordSeed(findSeedInChunk(table, lo, (lo + hi) / 2, shift),
+                          findSeedInChunk(table, (lo + hi) / 2, hi, shift));
+}
+
+// Search chunk by chunk so the common case (an early seed) stays cheap
+template <unsigned int Count>
+constexpr unsigned int findKeywordSeed(const KeywordEntry (&table)[Count], unsigned char shift,
+                                       unsigned int chunk = 0) {
+  return chunk >= kKeywordSeedLimit ? kKeywordSeedLimit
+       : findSeedInChunk(table, chunk, chunk + kKeywordSeedChunk, shift) != kKeywordSeedLimit
+         ? findSeedInChunk(table, chunk, chunk + kKeywordSeedChunk, shift)
+         : findKeywordSeed(table, shift, chunk + kKeywordSeedChunk);
+}
+
+template <unsigned int Count>
+constexpr unsigned char keywordInSlot(const KeywordEntry (&table)[Count], unsigned int slot,
+                                      unsigned int seed, unsigned char shift,
+                                      unsigned int index = 0) {
+  return index >= Count ? kNoKeyword
+       : keywordSlot(table, index, seed, shift) == slot ? (unsigned char)index
+       : keywordInSlot(table, slot, seed, shift, index + 1);
+}
+
+// Minimal index_sequence (no <utility> on AVR)
+template <unsigned int... I> struct KeywordIndexList {};
+template <unsigned int N, unsigned int... I>
+struct MakeKeywordIndexList : MakeKeywordIndexList<N - 1, N - 1, I...> {};
+template <unsigned int... I>
+struct MakeKeywordIndexList<0, I...> { typedef KeywordIndexList<I...> type; };
+
+template <unsigned int Count, unsigned int... Slot>
+constexpr KeywordSlots<sizeof...(Slot)> buildKeywordSlots(const KeywordEntry (&table)[Count],
+                                                          unsigned int seed, unsigned char shift,
+                                                          KeywordIndexList<Slot...>) {
+  return KeywordSlots<sizeof...(Slot)>{
+    (unsigned short)seed, shift, {keywordInSlot(table, Slot, seed, shift)...}
+  };
+}
+
+// Build the slot index for a keyword table with Slots (a power of two) slots
+template <unsigned int Slots, unsigned int Count>
+constexpr KeywordSlots<Slots> makeKeywordSlots(const KeywordEntry (&table)[Count]) {
+  return buildKeywordSlots(table, findKeywordSeed(table, slotShift(Slots)), slotShift(Slots),
+                           typename MakeKeywordIndexList<Slots>::type());
+}
+
+template <unsigned int Slots, unsigned int Count>
+constexpr bool hasPerfectKeywordHash(const KeywordEntry (&table)[Count]) {
+  return findKeywordSeed(table, slotShift(Slots)) != kKeywordSeedLimit;
+}
+
+inline char keywordLower(char c) {
+  return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+}
+
+// Look up [text, text+length) case-insensitively. Both the table and the
+// slot index live in flash. Returns the keyword's value or notFound.
+template <unsigned int Slots, unsigned int Count>
+unsigned char findKeyword(const KeywordEntry (&table)[Count], const KeywordSlots<Slots> &slots,
+                          const char *text, unsigned int length, unsigned char notFound) {
+  if (length == 0 || length > kMaxKeywordLength) {
+    return notFound;
+  }
+
+  unsigned int hash = pgm_read_word(&slots.seed);
+  for (unsigned int i = 0; i < length; i++) {
+    hash = keywordHashStep(hash, keywordLower(text[i]));
+  }
+
+  unsigned char index = pgm_read_byte(&slots.slot[hash >> pgm_read_byte(&slots.shift)]);
+  if (index == kNoKeyword) {
+    return notFound;
+  }
+
+  const char *name = table[index].name;
+  for (unsigned int i = 0; i < length; i++) {
+    if ((char)pgm_read_byte(&name[i]) != keywordLower(text[i])) {
+      return notFound;
+    }
+  }
+  if (pgm_read_byte(&name[length]) != '\0') {
+    return notFound;
+  }
+  return pgm_read_byte(&table[index].value);
+}
+
+#endif
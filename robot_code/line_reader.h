@@ -0,0 +1,111 @@
+// Smart Waiter Robot - Non-blocking Line Reader
+// Drains a Stream into a fixed ring buffer and assembles complete lines,
+// so a partial command never stalls the control loop.
+//
+// Text lines end with '\n'. A line that starts with 0x00 is a binary frame
+// (see robot_protocol.h) and ends at the next 0x00 instead.
+
+#ifndef LINE_READER_H
+#define LINE_READER_H
+
+// RingSize must be a power of two. MaxLineLength excludes the terminator.
+template <unsigned int RingSize, unsigned int MaxLineLength>
+class LineReader {
+public:
+  LineReader() : head(0), tail(0), lineLength(0), length(0), discarding(false),
+                 inFrame(false), lineIsFrame(false), tooLong(0) {
+    lineBuffer[0] = '\0';
+  }
+
+  // Copy every byte the stream has ready into the ring buffer. If the ring
+  // fills up the rest is left in the stream for the next tick; nothing is
+  // lost unless the stream's own receive buffer overflows meanwhile.
+  template <typename StreamType>
+  void poll(StreamType &stream) {
+    while (stream.available() > 0) {
+      if ((unsigned int)(head - tail) >= RingSize) {
+        return;
+      }
+      int c = stream.read();
+      if (c < 0) {
+        return;
+      }
+      ring[head & (RingSize - 1)] = (char)c;
+      head++;
+    }
+  }
+
+  // Assemble the next complete line from buffered bytes. Returns true when
+  // a non-empty line or frame is ready in line(); partial lines stay
+  // buffered until their delimiter arrives. Lines longer than MaxLineLength
+  // are discarded.
+  bool readLine() {
+    while (tail != head) {
+      char c = ring[tail & (RingSize - 1)];
+      tail++;
+
+      // 0x00 starts a binary frame (dropping any partial text line) or,
+      // inside a frame, ends it
+      bool endOfLine = inFrame ? c == '\0' : c == '\n';
+      if (!inFrame && c == '\0') {
+        inFrame = true;
+        discarding = false;
+        lineLength = 0;
+        continue;
+      }
+
+      if (endOfLine) {
+        bool complete = !discarding && lineLength > 0;
+        lineBuffer[lineLength] = '\0';
+        length = lineLength;
+        lineIsFrame = inFrame;
+        lineLength = 0;
+        discarding = false;
+        inFrame = false;
+        if (complete) {
+          return true;
+        }
+        continue;
+      }
+
+      if (discarding || (c == '\r' && !inFrame)) {
+        continue;
+      }
+
+      if (lineLength >= MaxLineLength) {
+        tooLong++;
+        discarding = true;
+        lineLength = 0;
+        continue;
+      }
+
+      lineBuffer[lineLength++] = c;
+    }
+    return false;
+  }
+
+  const char *line() const { return lineBuffer; }
+  unsigned int lineSize() const { return length; }
+  // True if the last line returned was a binary frame (COBS block without
+  // its delimiters), which may be decoded in place
+  bool lineIsBinary() const { return lineIsFrame; }
+  unsigned char *frame() { return (unsigned char *)lineBuffer; }
+
+  unsigned long tooLongCount() const { return tooLong; }
+
+private:
+  char ring[RingSize];
+  unsigned int head;
+  unsigned int tail;
+
+  char lineBuffer[MaxLineLength + 1];
+  unsigned int lineLength;
+  unsigned int length;
+  bool discarding;
+  bool inFrame;
+  bool lineIsFrame;
+
+  unsigned long tooLong;
+};
+
+#endif
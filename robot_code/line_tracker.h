@@ -0,0 +1,161 @@
+// Smart Waiter Robot - PID Line Tracker
+// Estimates where the line is under the sensor bar (weighted centroid) and
+// turns that into differential motor PWM with a fixed-point PID controller.
+
+#ifndef LINE_TRACKER_H
+#define LINE_TRACKER_H
+
+const unsigned char kLineSensorCount = 3;
+
+// Line position runs from -1000 (under the left sensor) through 0 (center)
+// to +1000 (under the right sensor)
+const int kLinePositionRange = 1000;
+
+// Gains are fixed point with 8 fractional bits: 256 = 1.0 PWM step per unit
+// of line position (kp), per unit-tick of accumulated error (ki) or per unit
+// change between ticks (kd)
+const unsigned char kPidShift = 8;
+const int kPidMaxGain = 4095;
+const long kPidIntegralLimit = 64000L;
+
+class LineTracker {
+public:
+  LineTracker(int baseSpeed) : kp(51), ki(0), kd(1280), baseSpeed(baseSpeed),
+                               driveSpeed(baseSpeed), lineOnThreshold(600),
+                               lineOffThreshold(400) {
+    for (unsigned char i = 0; i < kLineSensorCount; i++) {
+      sensorOnLine[i] = false;
+    }
+    reset();
+  }
+
+  void setGains(int newKp, int newKi, int newKd) {
+    kp = constrainGain(newKp);
+    ki = constrainGain(newKi);
+    kd = constrainGain(newKd);
+    integral = 0;
+  }
+
+  // Cruise speed (PWM) set by TUNE; the top of the motion profile
+  void setBaseSpeed(int speed) { baseSpeed = constrainPwm(speed); }
+
+  // Forward PWM for the coming updates, from the motion profile (ramps
+  // and braking); steering corrections are added on top
+  void setDriveSpeed(int speed) { driveSpeed = constrainPwm(speed); }
+
+  // Hysteresis on darkness (0-1000): a sensor starts seeing the line above
+  // onThreshold and keeps seeing it until it drops below offThreshold, so
+  // readings hovering near one threshold do not flicker in and out
+  void setLineThresholds(int onThreshold, int offThreshold) {
+    lineOnThreshold = onThreshold;
+    lineOffThreshold = offThreshold < onThreshold ? offThreshold : onThreshold;
+  }
+
+  // Take a branch at a junction: with the line splitting, only the sensors
+  // on the chosen side (and the center) count towards the position.
+  // -1 = left, 0 = follow the line as usual, +1 = right.
+  void setBranch(int side) { branch = side; }
+
+  int proportionalGain() const { return kp; }
+  int integralGain() const { return ki; }
+  int derivativeGain() const { return kd; }
+  int speed() const { return baseSpeed; }
+
+  // Clear controller history, e.g. at the start of a journey. Which sensors
+  // are on the line is kept: the robot has not moved, and a sensor stopped
+  // on the tape's edge must not need the full on threshold to count again.
+  void reset() {
+    linePosition = 0;
+    lastError = 0;
+    integral = 0;
+    detected = false;
+    branch = 0;
+    leftPwm = 0;
+    rightPwm = 0;
+  }
+
+  // One control step. darkness[] is 0 (white) to 1000 (black) for the left,
+  // center and right sensors. Returns false if no sensor sees the line, in
+  // which case the position holds at the side the line was last seen.
+  bool update(const int darkness[kLineSensorCount]) {
+    static const int sensorPosition[kLineSensorCount] = {
+      -kLinePositionRange, 0, kLinePositionRange
+    };
+
+    long weighted = 0;
+    long total = 0;
+    for (unsigned char i = 0; i < kLineSensorCount; i++) {
+      int threshold = sensorOnLine[i] ? lineOffThreshold : lineOnThreshold;
+      sensorOnLine[i] = darkness[i] > threshold;
+      if (sensorOnLine[i] && sensorPosition[i] * branch >= 0) {
+        // Weighted from the off threshold, so a sensor's pull fades out
+        // smoothly as the line leaves it
+        long weight = darkness[i] - lineOffThreshold + 1;
+        weighted += weight * sensorPosition[i];
+        total += weight;
+      }
+    }
+
+    detected = total > 0;
+    if (detected) {
+      linePosition = (int)(weighted / total);
+    } else if (linePosition != 0) {
+      // Lost it: steer hard towards the side it disappeared on
+      linePosition = linePosition < 0 ? -kLinePositionRange : kLinePositionRange;
+    }
+
+    // Positive error means the line is to the right, so speed up the left wheel
+    long error = linePosition;
+    integral += error;
+    if (integral > kPidIntegralLimit) integral = kPidIntegralLimit;
+    if (integral < -kPidIntegralLimit) integral = -kPidIntegralLimit;
+    long derivative = error - lastError;
+    lastError = error;
+
+    long correction = ((long)kp * error + (long)ki * integral +
+                       (long)kd * derivative) >> kPidShift;
+
+    leftPwm = constrainPwm(driveSpeed + correction);
+    rightPwm = constrainPwm(driveSpeed - correction);
+    return detected;
+  }
+
+  int position() const { return linePosition; }
+  bool lineDetected() const { return detected; }
+
+  // Signed PWM for each motor, -255 (full reverse) to 255 (full forward)
+  int leftOutput() const { return leftPwm; }
+  int rightOutput() const { return rightPwm; }
+
+private:
+  int kp;
+  int ki;
+  int kd;
+  int baseSpeed;
+  int driveSpeed;
+  int lineOnThreshold;
+  int lineOffThreshold;
+  bool sensorOnLine[kLineSensorCount];
+  int branch;
+
+  int linePosition;
+  long lastError;
+  long integral;
+  bool detected;
+  int leftPwm;
+  int rightPwm;
+
+  static int constrainGain(int value) {
+    if (value > kPidMaxGain) return kPidMaxGain;
+    if (value < 0) return 0;
+    return value;
+  }
+
+  static int constrainPwm(long value) {
+    if (value > 255) return 255;
+    if (value < -255) return -255;
+    return (int)value;
+  }
+};
+
+#endif
@@ -0,0 +1,125 @@
+// Smart Waiter Robot - Motion Profile
+// Trapezoidal speed profile for journeys: ramp up at a set acceleration,
+// cruise, and brake at a set deceleration so the robot reaches its stop at
+// a slow creep instead of cutting the motors at full speed. Wheels no
+// longer slip at the start and plates stay put at the table.
+//
+// Speeds are in mm/s, held with 8 fractional bits so the per-tick change
+// at 1 kHz (0.5 mm/s at 500 mm/s^2) is not lost to rounding. A linear motor
+// model turns them into PWM: the wheels start turning at startPwm and
+// reach fullSpeedMmS at 255.
+
+#ifndef MOTION_PROFILE_H
+#define MOTION_PROFILE_H
+
+const unsigned char kProfileShift = 8;
+
+// Largest step between updates; a stalled loop must not turn into a jump
+const unsigned long kProfileMaxStepMs = 50;
+
+// Integer square root (floor), for the braking curve
+inline unsigned long profileSqrt(unsigned long value) {
+  unsigned long root = 0;
+  unsigned long bit = 1UL << 30;
+  while (bit > value) {
+    bit >>= 2;
+  }
+  while (bit != 0) {
+    if (value >= root + bit) {
+      value -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return root;
+}
+
+class MotionProfile {
+public:
+  MotionProfile()
+    : accelMmS2(500), decelMmS2(400), creepMmS(60), startPwm(50), fullSpeedMmS(700),
+      speedQ(0), lastUpdate(0) {}
+
+  // Ramp rates in mm/s^2 and the speed the stop is approached at
+  void setLimits(long accel, long decel, long creep) {
+    accelMmS2 = accel > 0 ? accel : 1;
+    decelMmS2 = decel > 0 ? decel : 1;
+    creepMmS = creep > 0 ? creep : 1;
+  }
+
+  void setMotorModel(int newStartPwm, long newFullSpeedMmS) {
+    startPwm = newStartPwm;
+    fullSpeedMmS = newFullSpeedMmS > 0 ? newFullSpeedMmS : 1;
+  }
+
+  // Standing start
+  void start(unsigned long nowMillis) {
+    speedQ = 0;
+    lastUpdate = nowMillis;
+  }
+
+  // One step towards cruiseMmS. remainingMm is the distance left to the
+  // stop, or negative if there is none in sight; within braking distance
+  // the speed follows v^2 = creep^2 + 2 * decel * remaining.
+  void update(unsigned long nowMillis, long cruiseMmS, long remainingMm) {
+    unsigned long elapsed = nowMillis - lastUpdate;
+    lastUpdate = nowMillis;
+    if (elapsed > kProfileMaxStepMs) {
+      elapsed = kProfileMaxStepMs;
+    }
+
+    long limitMmS = cruiseMmS;
+    if (remainingMm >= 0 && remainingMm < brakingDistanceMm(cruiseMmS)) {
+      long braking = (long)profileSqrt((unsigned long)(creepMmS * creepMmS +
+                                                       2 * decelMmS2 * remainingMm));
+      if (braking < limitMmS) {
+        limitMmS = braking;
+      }
+    }
+    long limitQ = limitMmS << kProfileShift;
+
+    long stepQ = ((long)elapsed * accelMmS2 << kProfileShift) / 1000;
+    if (speedQ < limitQ) {
+      speedQ = speedQ + stepQ < limitQ ? speedQ + stepQ : limitQ;
+    } else {
+      // Over the braking curve (or the cruise speed was lowered)
+      long brakeQ = ((long)elapsed * decelMmS2 << kProfileShift) / 1000;
+      speedQ = speedQ - brakeQ > limitQ ? speedQ - brakeQ : limitQ;
+    }
+  }
+
+  long speedMmS() const { return speedQ >> kProfileShift; }
+
+  // Distance needed to brake from speedMmS to the creep speed
+  long brakingDistanceMm(long speed) const {
+    return speed <= creepMmS ? 0 : (speed * speed - creepMmS * creepMmS) / (2 * decelMmS2);
+  }
+
+  // Motor model: PWM for a speed, and the speed a PWM gives
+  int pwmFor(long speed) const {
+    if (speed <= 0) {
+      return 0;
+    }
+    long pwm = startPwm + speed * (255 - startPwm) / fullSpeedMmS;
+    return pwm > 255 ? 255 : (int)pwm;
+  }
+
+  long speedFor(int pwm) const {
+    return pwm <= startPwm ? 0 : (long)(pwm - startPwm) * fullSpeedMmS / (255 - startPwm);
+  }
+
+  int pwm() const { return pwmFor(speedMmS()); }
+
+private:
+  long accelMmS2;
+  long decelMmS2;
+  long creepMmS;
+  int startPwm;
+  long fullSpeedMmS;
+  long speedQ;
+  unsigned long lastUpdate;
+};
+
+#endif
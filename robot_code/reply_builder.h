@@ -0,0 +1,280 @@
+// Smart Waiter Robot - Reply Builder
+// Renders a whole reply (a JSON line and/or binary frames) into a fixed
+// stack buffer so it can be sent with a single write. SoftwareSerial
+// transmits with interrupts disabled, so sending one message instead of a
+// burst of small print() calls keeps the control loop's stalls short and
+// predictable.
+//
+// Keys and string values can be RAM strings or flash strings from F(), so
+// the sketch's fixed text stays out of the Uno's 2 KB of RAM.
+
+#ifndef REPLY_BUILDER_H
+#define REPLY_BUILDER_H
+
+#ifdef __AVR__
+#include <avr/pgmspace.h>
+#endif
+
+#ifndef pgm_read_byte
+#define pgm_read_byte(address) (*(const unsigned char *)(address))
+#endif
+
+#include "robot_protocol.h"
+
+class __FlashStringHelper;
+
+// Room for the longest replies, a METRICS section with every field at its
+// widest (checked in the sketch), plus the tail below
+const unsigned int kReplyCapacity = 256;
+
+// Held back from the fields so a reply that runs out of room can still be
+// closed: ,"truncated":true}\r\n
+const unsigned int kReplyTailBytes = 20;
+
+// Widest rendered values, for reply budgets checked with static_assert
+const unsigned int kReplyIntBytes = 6;    // -32768
+const unsigned int kReplyLongBytes = 11;  // -2147483648
+const unsigned int kReplyULongBytes = 10; // 4294967295
+const unsigned int kReplyBoolBytes = 5;   // false
+
+constexpr unsigned int replyTextLength(const char *text) {
+  return *text ? 1 + replyTextLength(text + 1) : 0;
+}
+
+// A quoted string value
+constexpr unsigned int replyTextBytes(const char *text) {
+  return replyTextLength(text) + 2;
+}
+
+// A field at its widest: ,"key": and the value
+constexpr unsigned int replyFieldBytes(const char *key, unsigned int valueBytes) {
+  return replyTextLength(key) + 4 + valueBytes;
+}
+
+// A field that does not fit is dropped whole, along with every field after
+// it, and the object ends with "truncated":true, so the line is always
+// complete JSON. A frame that does not fit is dropped.
+template <unsigned int Capacity>
+class ReplyBuilder {
+  static_assert(Capacity > kReplyTailBytes + kMaxEncodedFrame,
+                "reply: room for a frame and the closing tail");
+
+public:
+  ReplyBuilder() : length(0), fieldStart(0), fieldCount(0), truncated(false) {}
+
+  // JSON object: beginObject(), any number of field() calls, endObject().
+  // Key is const char * or const __FlashStringHelper *.
+  void beginObject() {
+    append('{');
+    fieldCount = 0;
+  }
+
+  template <typename Key>
+  void field(Key key, const char *value) {
+    beginField(key);
+    appendQuoted(value);
+    endField();
+  }
+
+  template <typename Key>
+  void field(Key key, const __FlashStringHelper *value) {
+    beginField(key);
+    appendQuoted(value);
+    endField();
+  }
+
+  template <typename Key>
+  void field(Key key, int value) { field(key, (long)value); }
+
+  template <typename Key>
+  void field(Key key, long value) {
+    beginField(key);
+    if (value < 0) {
+      append('-');
+      appendNumber(0UL - (unsigned long)value);
+    } else {
+      appendNumber((unsigned long)value);
+    }
+    endField();
+  }
+
+  template <typename Key>
+  void field(Key key, unsigned long value) {
+    beginField(key);
+    appendNumber(value);
+    endField();
+  }
+
+  // String value made of a prefix and a number, e.g. "table_3"
+  template <typename Key>
+  void field(Key key, const __FlashStringHelper *prefix, long value) {
+    beginField(key);
+    append('"');
+    append(prefix);
+    appendNumber((unsigned long)value);
+    append('"');
+    endField();
+  }
+
+  // Array of numbers, e.g. "min":[120,98,131]
+  template <typename Key>
+  void field(Key key, const unsigned int *values, unsigned char count) {
+    beginField(key);
+    append('[');
+    for (unsigned char i = 0; i < count; i++) {
+      if (i > 0) {
+        append(',');
+      }
+      appendNumber(values[i]);
+    }
+    append(']');
+    endField();
+  }
+
+  template <typename Key>
+  void field(Key key, const unsigned long *values, unsigned char count) {
+    beginField(key);
+    append('[');
+    for (unsigned char i = 0; i < count; i++) {
+      if (i > 0) {
+        append(',');
+      }
+      appendNumber(values[i]);
+    }
+    append(']');
+    endField();
+  }
+
+  // Array of strings, e.g. "queue":["go_to_table","return_home"]
+  template <typename Key, typename Text>
+  void field(Key key, const Text *const *values, unsigned char count) {
+    beginField(key);
+    append('[');
+    for (unsigned char i = 0; i < count; i++) {
+      if (i > 0) {
+        append(',');
+      }
+      appendQuoted(values[i]);
+    }
+    append(']');
+    endField();
+  }
+
+  template <typename Key>
+  void boolField(Key key, bool value) {
+    beginField(key);
+    append(value ? "true" : "false");
+    endField();
+  }
+
+  void endObject() {
+    if (truncated) {
+      appendTail(buffer[length - 1] == '{' ? "\"truncated\":true" : ",\"truncated\":true");
+    }
+    appendTail("}\r\n");
+  }
+
+  // Plain text line (CRLF added, even if the text is cut short)
+  void line(const char *text) {
+    append(text);
+    appendTail("\r\n");
+  }
+
+  // Append an encoded binary frame
+  void frame(FrameBuilder &builder) {
+    if (length + kMaxEncodedFrame > Capacity) {
+      truncated = true;
+      return;
+    }
+    length += builder.finish((unsigned char *)buffer + length);
+  }
+
+  bool empty() const { return length == 0; }
+  unsigned int size() const { return length; }
+  bool wasTruncated() const { return truncated; }
+  const char *data() const { return buffer; }
+
+  // Send everything in one write and return the number of bytes sent
+  template <typename StreamType>
+  unsigned int sendTo(StreamType &stream) {
+    if (length == 0) {
+      return 0;
+    }
+    return stream.write((const unsigned char *)buffer, length);
+  }
+
+private:
+  char buffer[Capacity];
+  unsigned int length;
+  unsigned int fieldStart;
+  unsigned char fieldCount;
+  bool truncated;
+
+  void append(char c) {
+    if (!truncated && length < Capacity - kReplyTailBytes) {
+      buffer[length++] = c;
+    } else {
+      truncated = true;
+    }
+  }
+
+  // Closing characters, into the room append() leaves
+  void appendTail(const char *text) {
+    while (*text && length < Capacity) {
+      buffer[length++] = *text++;
+    }
+  }
+
+  void append(const char *text) {
+    while (*text) {
+      append(*text++);
+    }
+  }
+
+  void append(const __FlashStringHelper *text) {
+    const char *flash = reinterpret_cast<const char *>(text);
+    char c;
+    while ((c = (char)pgm_read_byte(flash++)) != '\0') {
+      append(c);
+    }
+  }
+
+  template <typename Text>
+  void appendQuoted(Text text) {
+    append('"');
+    append(text);
+    append('"');
+  }
+
+  void appendNumber(unsigned long value) {
+    char digits[20];
+    unsigned char count = 0;
+    do {
+      digits[count++] = (char)('0' + value % 10);
+      value /= 10;
+    } while (value > 0 && count < sizeof(digits));
+    while (count > 0) {
+      append(digits[--count]);
+    }
+  }
+
+  template <typename Key>
+  void beginField(Key key) {
+    fieldStart = length;
+    if (fieldCount++ > 0) {
+      append(',');
+    }
+    append('"');
+    append(key);
+    append("\":");
+  }
+
+  // Take back a field that ran out of room
+  void endField() {
+    if (truncated) {
+      length = fieldStart;
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,228 @@
+// Smart Waiter Robot - Binary Link Protocol
+// Compact alternative to the JSON/text protocol, shared by the firmware and
+// the host-side library in host/. No Arduino or C++ library dependencies.
+//
+// Frame on the wire:
+//   0x00 | COBS( opcode | value varints... | crc16 lo | crc16 hi ) | 0x00
+//
+// - opcode:  requests (host -> robot) use the CommandId value; replies
+//            (robot -> host) have the top bit set, see ReplyOpcode
+// - values:  signed integers, zigzag + LEB128 varint encoded (1-5 bytes)
+// - crc16:   CRC-16/CCITT-FALSE over opcode and values
+//
+// Because COBS output never contains 0x00, frames can be mixed with
+// newline-terminated text commands on the same link: a line that starts
+// with 0x00 is a binary frame and ends at the next 0x00.
+//
+// The host sends a HELLO request to learn the robot's protocol version and
+// capabilities before using binary frames. Replies and events follow the
+// format of the most recent command: binary after any binary frame, text or
+// JSON again after any text command.
+
+#ifndef ROBOT_PROTOCOL_H
+#define ROBOT_PROTOCOL_H
+
+const unsigned char kProtocolVersion = 1;
+const unsigned char kFrameDelimiter = 0x00;
+const unsigned char kMaxFrameValues = 16;
+const unsigned char kMaxVarintBytes = 5;
+
+// Maximum unencoded frame: opcode + values + CRC
+const unsigned int kMaxFramePayload = 1 + kMaxFrameValues * kMaxVarintBytes + 2;
+// COBS adds one byte per 254 plus the leading code byte, framing adds two
+const unsigned int kMaxEncodedFrame = kMaxFramePayload + kMaxFramePayload / 254 + 1 + 2;
+
+enum ProtocolCapability {
+  CAP_JSON = 0x01,
+  CAP_TEXT = 0x02,
+  CAP_BINARY = 0x04
+};
+
+enum ReplyOpcode {
+  REPLY_ACK = 0x80,       // command id, result
+  REPLY_HELLO = 0x81,     // protocol version, capabilities
+  REPLY_STATUS = 0x82,    // state, current table, target table, at home, progress, eta
+  REPLY_EVENT = 0x83,     // RobotEvent, table (calibrated: 1 = ok, 0 = failed)
+  REPLY_ERROR = 0x84,     // ReplyResult
+  REPLY_QUEUE = 0x85,     // depth, then command id and first argument per entry
+  REPLY_METRICS = 0x86,   // section, then timings (see sendMetrics in the sketch)
+  REPLY_TELEMETRY = 0x87  // header, then values or deltas (telemetry_stream.h)
+};
+
+enum ReplyResult {
+  RESULT_OK,
+  RESULT_INVALID_ARGUMENT,
+  RESULT_UNKNOWN_COMMAND,
+  RESULT_BAD_FRAME,
+  RESULT_QUEUE_FULL
+};
+
+enum RobotEvent {
+  EVENT_MOVING,
+  EVENT_RETURNING,
+  EVENT_STOPPED,
+  EVENT_ARRIVED,
+  EVENT_HOME,
+  EVENT_CALIBRATING,
+  EVENT_CALIBRATED,
+  EVENT_DEPARTED,
+  EVENT_QUEUED        // Queue depth instead of a table
+};
+
+// CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF), bitwise to save flash
+inline unsigned short crc16Update(unsigned short crc, unsigned char byte) {
+  crc ^= (unsigned short)byte << 8;
+  for (unsigned char bit = 0; bit < 8; bit++) {
+    crc = (crc & 0x8000) ? (unsigned short)((crc << 1) ^ 0x1021) : (unsigned short)(crc << 1);
+  }
+  return crc;
+}
+
+inline unsigned short crc16(const unsigned char *data, unsigned int length) {
+  unsigned short crc = 0xFFFF;
+  for (unsigned int i = 0; i < length; i++) {
+    crc = crc16Update(crc, data[i]);
+  }
+  return crc;
+}
+
+// COBS-encode length bytes into out (which needs length + length/254 + 1
+// bytes). Returns the encoded length.
+inline unsigned int cobsEncode(const unsigned char *in, unsigned int length, unsigned char *out) {
+  unsigned int codeIndex = 0;
+  unsigned int outIndex = 1;
+  unsigned char code = 1;
+
+  for (unsigned int i = 0; i < length; i++) {
+    if (in[i] == 0) {
+      out[codeIndex] = code;
+      codeIndex = outIndex++;
+      code = 1;
+      continue;
+    }
+    out[outIndex++] = in[i];
+    if (++code == 0xFF) {
+      out[codeIndex] = code;
+      codeIndex = outIndex++;
+      code = 1;
+    }
+  }
+  out[codeIndex] = code;
+  return outIndex;
+}
+
+// Decode a COBS block (without delimiters). in and out may be the same
+// buffer. Returns the decoded length, or -1 if the block is malformed.
+inline int cobsDecode(const unsigned char *in, unsigned int length, unsigned char *out) {
+  unsigned int inIndex = 0;
+  unsigned int outIndex = 0;
+
+  while (inIndex < length) {
+    unsigned char code = in[inIndex++];
+    if (code == 0 || inIndex + code - 1 > length) {
+      return -1;
+    }
+    for (unsigned char i = 1; i < code; i++) {
+      out[outIndex++] = in[inIndex++];
+    }
+    if (code != 0xFF && inIndex < length) {
+      out[outIndex++] = 0;
+    }
+  }
+  return (int)outIndex;
+}
+
+inline unsigned long zigzagEncode(long value) {
+  return value < 0 ? ((unsigned long)(-(value + 1)) << 1) | 1 : (unsigned long)value << 1;
+}
+
+inline long zigzagDecode(unsigned long value) {
+  return (value & 1) ? -(long)(value >> 1) - 1 : (long)(value >> 1);
+}
+
+// Builds one frame: opcode, then values, then finish() adds the CRC and
+// COBS framing. Values are limited to the 32-bit range.
+class FrameBuilder {
+public:
+  void begin(unsigned char opcode) {
+    length = 0;
+    payload[length++] = opcode;
+  }
+
+  bool add(long value) {
+    if (length + kMaxVarintBytes + 2 > kMaxFramePayload) {
+      return false;
+    }
+    unsigned long remaining = zigzagEncode(value) & 0xFFFFFFFFUL;
+    do {
+      unsigned char byte = remaining & 0x7F;
+      remaining >>= 7;
+      payload[length++] = remaining ? (byte | 0x80) : byte;
+    } while (remaining);
+    return true;
+  }
+
+  // Encode into out (kMaxEncodedFrame bytes). Returns the bytes to send.
+  unsigned int finish(unsigned char *out) {
+    unsigned short crc = crc16(payload, length);
+    payload[length] = crc & 0xFF;
+    payload[length + 1] = crc >> 8;
+    out[0] = kFrameDelimiter;
+    unsigned int encoded = cobsEncode(payload, length + 2, out + 1);
+    out[encoded + 1] = kFrameDelimiter;
+    return encoded + 2;
+  }
+
+private:
+  unsigned char payload[kMaxFramePayload];
+  unsigned int length;
+};
+
+// Decodes one received frame (the COBS block between delimiters) in place
+class FrameReader {
+public:
+  FrameReader() : data(0), length(0), pos(0) {}
+
+  // Returns false if the frame is malformed or fails its CRC
+  bool open(unsigned char *frame, unsigned int frameLength) {
+    int decoded = cobsDecode(frame, frameLength, frame);
+    if (decoded < 3) {
+      return false;
+    }
+    unsigned short expected = frame[decoded - 2] | ((unsigned short)frame[decoded - 1] << 8);
+    if (crc16(frame, decoded - 2) != expected) {
+      return false;
+    }
+    data = frame;
+    length = (unsigned int)decoded - 2;
+    pos = 1;
+    return true;
+  }
+
+  unsigned char opcode() const { return data[0]; }
+  bool atEnd() const { return pos >= length; }
+
+  // Next value; returns false at the end of the frame or on a bad varint
+  bool next(long &value) {
+    unsigned long result = 0;
+    for (unsigned char shift = 0; shift < 7 * kMaxVarintBytes; shift += 7) {
+      if (pos >= length) {
+        return false;
+      }
+      unsigned char byte = data[pos++];
+      result |= (unsigned long)(byte & 0x7F) << shift;
+      if (!(byte & 0x80)) {
+        value = zigzagDecode(result & 0xFFFFFFFFUL);
+        return true;
+      }
+    }
+    return false;
+  }
+
+private:
+  unsigned char *data;
+  unsigned int length;
+  unsigned int pos;
+};
+
+#endif
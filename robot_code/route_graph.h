@@ -0,0 +1,544 @@
+// Smart Waiter Robot - Route Graph
+// The track is described as a directed graph of nodes (home, tables and
+// junctions) joined by line segments. The compiler runs Floyd-Warshall over
+// it and stores, for every pair of nodes, the route length, the number of
+// markers crossed and the branch to take at each decision point, in a flash
+// table. At runtime a journey is one table read; there is no path search
+// and no RAM spent on the graph.
+//
+// A segment can usually be followed either way, so the search runs over
+// stations: each node once per heading (along the segments as listed, or
+// against them). The table covers every pair of stations, and the robot
+// picks whichever departure and arrival heading is shortest, turning round
+// in place when that pays (planRoute).
+//
+// Like keyword_table.h, the constexpr functions are C++11 (single return
+// statements) so they build with the Arduino AVR toolchain.
+
+#ifndef ROUTE_GRAPH_H
+#define ROUTE_GRAPH_H
+
+#ifdef __AVR__
+#include <avr/pgmspace.h>
+#endif
+
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+
+#ifndef pgm_read_byte
+#define pgm_read_byte(address) (*(const unsigned char *)(address))
+#endif
+
+#ifndef pgm_read_word
+#define pgm_read_word(address) (*(const unsigned short *)(address))
+#endif
+
+#ifndef pgm_read_dword
+#define pgm_read_dword(address) (*(const unsigned long *)(address))
+#endif
+
+const unsigned char kNoEdge = 0xFF;
+const unsigned short kNoRoute = 0xFFFF;
+
+// reverseTurn of a segment that may only be followed from -> to
+const unsigned char kOneWay = 0xFF;
+
+// Decisions per route: one on departure plus one per marker crossed
+const unsigned char kMaxRouteDecisions = 16;
+
+enum TurnDirection {
+  TURN_STRAIGHT,
+  TURN_LEFT,
+  TURN_RIGHT
+};
+
+// One line segment. turn is the branch to take at `from` to get onto it
+// (TURN_STRAIGHT where there is no choice); reverseTurn is the branch to
+// take at `to` to follow it backwards, as seen by the robot facing that
+// way, or kOneWay.
+struct TrackEdge {
+  unsigned char from;
+  unsigned char to;
+  unsigned char turn;
+  unsigned short lengthMm;
+  unsigned char reverseTurn;
+};
+
+// Heading at a node: along the segments as listed, or against them
+enum TrackHeading {
+  HEADING_FORWARD,
+  HEADING_BACKWARD
+};
+
+// Station = node and heading, the unit routes are planned between
+constexpr unsigned char trackStation(unsigned int node, unsigned int heading) {
+  return (unsigned char)(node * 2 + heading);
+}
+
+inline unsigned char stationNode(unsigned char station) { return station >> 1; }
+inline TrackHeading stationHeading(unsigned char station) {
+  return (TrackHeading)(station & 1);
+}
+
+// Precomputed journey between two nodes
+struct Route {
+  unsigned short lengthMm;     // kNoRoute if there is no way there
+  unsigned char markers;       // Marked nodes crossed, destination included
+  unsigned char arriveByMarker; // Destination is marked (else: by distance)
+  unsigned long turns;         // 2 bits per decision: departure, then one
+                               // after each marker crossed
+};
+
+template <unsigned int Nodes>
+struct RouteTable {
+  Route route[Nodes * Nodes]; // [from * Nodes + to]
+};
+
+// Shortest known length and first edge for every (from, to) pair
+template <unsigned int Nodes>
+struct PathMatrix {
+  unsigned short length[Nodes * Nodes];
+  unsigned char edge[Nodes * Nodes];
+};
+
+// Minimal index_sequence (no <utility> on AVR)
+template <unsigned int... I> struct RouteIndexList {};
+template <unsigned int N, unsigned int... I>
+struct MakeRouteIndexList : MakeRouteIndexList<N - 1, N - 1, I...> {};
+template <unsigned int... I>
+struct MakeRouteIndexList<0, I...> { typedef RouteIndexList<I...> type; };
+
+// Segments between stations: each segment forwards, then backwards (an
+// edge that matches no station where the segment is one-way)
+template <unsigned int Edges>
+struct StationEdges {
+  TrackEdge edge[Edges * 2];
+};
+
+constexpr TrackEdge forwardEdge(const TrackEdge &edge) {
+  return TrackEdge{trackStation(edge.from, HEADING_FORWARD), trackStation(edge.to, HEADING_FORWARD),
+                   edge.turn, edge.lengthMm, kOneWay};
+}
+
+constexpr TrackEdge backwardEdge(const TrackEdge &edge) {
+  return edge.reverseTurn == kOneWay
+       ? TrackEdge{kNoEdge, kNoEdge, TURN_STRAIGHT, edge.lengthMm, kOneWay}
+       : TrackEdge{trackStation(edge.to, HEADING_BACKWARD),
+                   trackStation(edge.from, HEADING_BACKWARD),
+                   edge.reverseTurn, edge.lengthMm, kOneWay};
+}
+
+template <unsigned int Edges, unsigned int... I>
+constexpr StationEdges<Edges> buildStationEdges(const TrackEdge (&edges)[Edges],
+                                                RouteIndexList<I...>) {
+  return StationEdges<Edges>{{(I % 2 ? backwardEdge(edges[I / 2])
+                                     : forwardEdge(edges[I / 2]))...}};
+}
+
+template <unsigned int Edges>
+constexpr StationEdges<Edges> stationEdges(const TrackEdge (&edges)[Edges]) {
+  return buildStationEdges(edges, typename MakeRouteIndexList<Edges * 2>::type());
+}
+
+// Marked node mask to marked station mask (both headings of each node)
+constexpr unsigned long stationMarks(unsigned long markedNodes, unsigned int node = 0) {
+  return node >= 16 ? 0
+       : (((markedNodes >> node) & 1) ? 3UL << (2 * node) : 0) |
+         stationMarks(markedNodes, node + 1);
+}
+
+constexpr bool nodeMarked(unsigned long markedNodes, unsigned int node) {
+  return (markedNodes >> node) & 1;
+}
+
+// Shortest direct edge from -> to, or kNoEdge
+template <unsigned int Edges>
+constexpr unsigned char directEdge(const TrackEdge (&edges)[Edges], unsigned int from,
+                                   unsigned int to, unsigned int i = 0,
+                                   unsigned char best = kNoEdge) {
+  return i >= Edges ? best
+       : directEdge(edges, from, to, i + 1,
+                    edges[i].from == from && edges[i].to == to &&
+                    (best == kNoEdge || edges[i].lengthMm < edges[best].lengthMm)
+                    ? (unsigned char)i : best);
+}
+
+template <unsigned int Edges>
+constexpr unsigned short directLength(const TrackEdge (&edges)[Edges], unsigned int from,
+                                      unsigned int to) {
+  return from == to ? 0
+       : directEdge(edges, from, to) == kNoEdge ? kNoRoute
+       : edges[directEdge(edges, from, to)].lengthMm;
+}
+
+template <unsigned int Nodes, unsigned int Edges, unsigned int... I>
+constexpr PathMatrix<Nodes> directPaths(const TrackEdge (&edges)[Edges], RouteIndexList<I...>) {
+  return PathMatrix<Nodes>{
+    {directLength(edges, I / Nodes, I % Nodes)...},
+    {(I / Nodes == I % Nodes ? kNoEdge : directEdge(edges, I / Nodes, I % Nodes))...}
+  };
+}
+
+template <unsigned int Nodes>
+constexpr bool shorterVia(const PathMatrix<Nodes> &paths, unsigned int k, unsigned int i,
+                          unsigned int j) {
+  return paths.length[i * Nodes + k] != kNoRoute && paths.length[k * Nodes + j] != kNoRoute &&
+         (unsigned long)paths.length[i * Nodes + k] + paths.length[k * Nodes + j] <
+         paths.length[i * Nodes + j];
+}
+
+// One Floyd-Warshall pass: allow paths through node k
+template <unsigned int Nodes, unsigned int... I>
+constexpr PathMatrix<Nodes> relaxVia(const PathMatrix<Nodes> &paths, unsigned int k,
+                                     RouteIndexList<I...>) {
+  return PathMatrix<Nodes>{
+    {(shorterVia(paths, k, I / Nodes, I % Nodes)
+      ? (unsigned short)(paths.length[I / Nodes * Nodes + k] + paths.length[k * Nodes + I % Nodes])
+      : paths.length[I])...},
+    {(shorterVia(paths, k, I / Nodes, I % Nodes)
+      ? paths.edge[I / Nodes * Nodes + k] : paths.edge[I])...}
+  };
+}
+
+template <unsigned int Nodes>
+constexpr PathMatrix<Nodes> allPairs(const PathMatrix<Nodes> &paths, unsigned int k = 0) {
+  return k >= Nodes ? paths
+       : allPairs(relaxVia(paths, k, typename MakeRouteIndexList<Nodes * Nodes>::type()), k + 1);
+}
+
+template <unsigned int Nodes, unsigned int Edges>
+constexpr PathMatrix<Nodes> shortestPaths(const TrackEdge (&edges)[Edges]) {
+  return allPairs(directPaths<Nodes>(edges, typename MakeRouteIndexList<Nodes * Nodes>::type()));
+}
+
+// Node after `from` on the shortest path to `to`
+template <unsigned int Nodes, unsigned int Edges>
+constexpr unsigned int nextNode(const TrackEdge (&edges)[Edges], const PathMatrix<Nodes> &paths,
+                                unsigned int from, unsigned int to) {
+  return edges[paths.edge[from * Nodes + to]].to;
+}
+
+template <unsigned int Nodes>
+constexpr bool routeExists(const PathMatrix<Nodes> &paths, unsigned int from, unsigned int to) {
+  return from == to || paths.edge[from * Nodes + to] != kNoEdge;
+}
+
+template <unsigned int Nodes, unsigned int Edges>
+constexpr unsigned char routeMarkers(const TrackEdge (&edges)[Edges],
+                                     const PathMatrix<Nodes> &paths, unsigned long markedNodes,
+                                     unsigned int from, unsigned int to) {
+  return from == to || paths.edge[from * Nodes + to] == kNoEdge ? 0
+       : nodeMarked(markedNodes, nextNode(edges, paths, from, to)) +
+         routeMarkers(edges, paths, markedNodes, nextNode(edges, paths, from, to), to);
+}
+
+// Turn bits: the departure decision in slot 0, then the decision at each
+// marked node in the slot after the markers crossed so far
+template <unsigned int Nodes, unsigned int Edges>
+constexpr unsigned long routeTurns(const TrackEdge (&edges)[Edges],
+                                   const PathMatrix<Nodes> &paths, unsigned long markedNodes,
+                                   unsigned int from, unsigned int to, unsigned int slot = 0) {
+  return from == to || paths.edge[from * Nodes + to] == kNoEdge || slot >= kMaxRouteDecisions ? 0
+       : ((unsigned long)edges[paths.edge[from * Nodes + to]].turn << (2 * slot)) |
+         routeTurns(edges, paths, markedNodes, nextNode(edges, paths, from, to), to,
+                    slot + nodeMarked(markedNodes, nextNode(edges, paths, from, to)));
+}
+
+// True if every branch on the route is taken at departure or at a marked
+// node (an unmarked junction could not be recognised on the way)
+template <unsigned int Nodes, unsigned int Edges>
+constexpr bool routeDecisionsMarked(const TrackEdge (&edges)[Edges],
+                                    const PathMatrix<Nodes> &paths, unsigned long markedNodes,
+                                    unsigned int from, unsigned int to, bool departure = true) {
+  return from == to || paths.edge[from * Nodes + to] == kNoEdge ? true
+       : (departure || nodeMarked(markedNodes, from) ||
+          edges[paths.edge[from * Nodes + to]].turn == TURN_STRAIGHT) &&
+         routeDecisionsMarked(edges, paths, markedNodes, nextNode(edges, paths, from, to), to,
+                              false);
+}
+
+template <unsigned int Nodes, unsigned int Edges>
+constexpr Route makeRoute(const TrackEdge (&edges)[Edges], const PathMatrix<Nodes> &paths,
+                          unsigned long markedNodes, unsigned int from, unsigned int to) {
+  return Route{
+    paths.length[from * Nodes + to],
+    routeMarkers(edges, paths, markedNodes, from, to),
+    (unsigned char)nodeMarked(markedNodes, to),
+    routeTurns(edges, paths, markedNodes, from, to)
+  };
+}
+
+template <unsigned int Nodes, unsigned int Edges, unsigned int... I>
+constexpr RouteTable<Nodes> buildRouteTable(const TrackEdge (&edges)[Edges],
+                                            const PathMatrix<Nodes> &paths,
+                                            unsigned long markedNodes, RouteIndexList<I...>) {
+  return RouteTable<Nodes>{{makeRoute(edges, paths, markedNodes, I / Nodes, I % Nodes)...}};
+}
+
+// All-pairs route table for a layout. markedNodes has bit n set if node n
+// has a cross-line marker.
+template <unsigned int Nodes, unsigned int Edges>
+constexpr RouteTable<Nodes> makeRouteTable(const TrackEdge (&edges)[Edges],
+                                           unsigned long markedNodes) {
+  return buildRouteTable(edges, shortestPaths<Nodes>(edges), markedNodes,
+                         typename MakeRouteIndexList<Nodes * Nodes>::type());
+}
+
+// Layout checks for static_assert, over the station graph: every node
+// reachable from every other (in some heading, turning round at the start
+// if need be), and every route short enough and decidable on the way
+template <unsigned int Stations, unsigned int Edges>
+constexpr bool routeUsable(const TrackEdge (&edges)[Edges], const PathMatrix<Stations> &paths,
+                           unsigned long markedStations, unsigned int from, unsigned int to) {
+  return !routeExists(paths, from, to) ||
+         (routeMarkers(edges, paths, markedStations, from, to) < kMaxRouteDecisions &&
+          routeDecisionsMarked(edges, paths, markedStations, from, to));
+}
+
+template <unsigned int Stations>
+constexpr bool nodesConnected(const PathMatrix<Stations> &paths, unsigned int fromNode,
+                              unsigned int toNode) {
+  return routeExists(paths, trackStation(fromNode, 0), trackStation(toNode, 0)) ||
+         routeExists(paths, trackStation(fromNode, 0), trackStation(toNode, 1)) ||
+         routeExists(paths, trackStation(fromNode, 1), trackStation(toNode, 0)) ||
+         routeExists(paths, trackStation(fromNode, 1), trackStation(toNode, 1));
+}
+
+template <unsigned int Stations, unsigned int Edges>
+constexpr bool routesUsable(const TrackEdge (&edges)[Edges], const PathMatrix<Stations> &paths,
+                            unsigned long markedStations, unsigned int lo, unsigned int hi) {
+  return lo >= hi ? true
+       : hi - lo == 1
+         ? routeUsable(edges, paths, markedStations, lo / Stations, lo % Stations) &&
+           nodesConnected(paths, lo / Stations / 2, lo % Stations / 2)
+       : routesUsable(edges, paths, markedStations, lo, (lo + hi) / 2) &&
+         routesUsable(edges, paths, markedStations, (lo + hi) / 2, hi);
+}
+
+template <unsigned int Stations, unsigned int Edges>
+constexpr bool layoutRoutable(const TrackEdge (&edges)[Edges], unsigned long markedStations) {
+  return routesUsable(edges, shortestPaths<Stations>(edges), markedStations, 0,
+                      Stations * Stations);
+}
+
+template <unsigned int Edges>
+constexpr bool edgesValid(const TrackEdge (&edges)[Edges], unsigned int nodes,
+                          unsigned int i = 0) {
+  return i >= Edges ? true
+       : edges[i].from < nodes && edges[i].to < nodes && edges[i].from != edges[i].to &&
+         edges[i].lengthMm > 0 && edges[i].lengthMm < kNoRoute && edges[i].turn <= TURN_RIGHT &&
+         (edges[i].reverseTurn <= TURN_RIGHT || edges[i].reverseTurn == kOneWay) &&
+         edgesValid(edges, nodes, i + 1);
+}
+
+// Copy one route out of a flash table
+template <unsigned int Nodes>
+Route readRoute(const RouteTable<Nodes> &table, unsigned char from, unsigned char to) {
+  const Route *entry = &table.route[from * Nodes + to];
+  Route route;
+  route.lengthMm = pgm_read_word(&entry->lengthMm);
+  route.markers = pgm_read_byte(&entry->markers);
+  route.arriveByMarker = pgm_read_byte(&entry->arriveByMarker);
+  route.turns = pgm_read_dword(&entry->turns);
+  return route;
+}
+
+// Where the robot is: offsetMm past station `behind`, on the way to the
+// next station `ahead` of the route it was following. Stopped at a station,
+// behind and ahead are that station and the offset is 0.
+struct TrackPosition {
+  unsigned char behind;
+  unsigned char ahead;
+  long offsetMm;
+};
+
+inline TrackPosition stationPosition(unsigned char station) {
+  TrackPosition position = {station, station, 0};
+  return position;
+}
+
+// A journey from where the robot is to a node
+struct RoutePlan {
+  Route route;
+  unsigned char from;       // Station the route starts at
+  unsigned char to;         // Station it arrives at
+  bool turnAround;          // Turn round in place before setting off
+  long approachMm;          // Distance to `from` first; negative if already past it
+  bool approachMarker;      // `from` is marked and lies ahead, not behind
+  long costMm;              // What the plan was chosen on, turn included
+};
+
+// Length of the shortest route between two stations (0 for the same one)
+template <unsigned int Stations>
+long routeLengthMm(const RouteTable<Stations> &table, unsigned char from, unsigned char to) {
+  return from == to ? 0 : readRoute(table, from, to).lengthMm;
+}
+
+// Cheapest way from `position` to `node`: carry on to the station ahead
+// and route from there, or turn round, go back to the station behind and
+// route from that, at a cost of turnAroundMm. Routes from the station
+// behind may leave on another segment than the one the robot is on, so
+// they are only used after turning round. Returns false if the node
+// cannot be reached.
+template <unsigned int Stations>
+bool planRoute(const RouteTable<Stations> &table, const TrackPosition &position,
+               unsigned char node, long turnAroundMm, RoutePlan &plan) {
+  long segmentMm = routeLengthMm(table, position.behind, position.ahead);
+  long best = -1;
+  for (unsigned char turn = 0; turn < 2; turn++) {
+    unsigned char from = turn ? position.behind ^ 1 : position.ahead;
+    long approachMm = turn ? position.offsetMm : segmentMm - position.offsetMm;
+    for (unsigned char heading = 0; heading < 2; heading++) {
+      unsigned char to = trackStation(node, heading);
+      Route route = readRoute(table, from, to);
+      if (route.lengthMm == kNoRoute) {
+        continue;
+      }
+      long cost = route.lengthMm + approachMm + (turn ? turnAroundMm : 0);
+      if (best < 0 || cost < best) {
+        best = cost;
+        plan.route = route;
+        plan.from = from;
+        plan.to = to;
+        plan.turnAround = turn;
+        plan.approachMm = approachMm;
+        plan.approachMarker = approachMm > 0 && readRoute(table, from, from).arriveByMarker;
+        plan.costMm = cost;
+      }
+    }
+  }
+  return best >= 0;
+}
+
+// Station after `from` on the shortest route to `to` (`to` itself if there
+// is none in between): the nearest one the route passes through
+template <unsigned int Stations>
+unsigned char routeNextStation(const RouteTable<Stations> &table, unsigned char from,
+                               unsigned char to) {
+  long wholeMm = routeLengthMm(table, from, to);
+  unsigned char next = to;
+  long nextMm = wholeMm;
+  for (unsigned char station = 0; station < Stations; station++) {
+    if (station == from || station == to) {
+      continue;
+    }
+    Route leg = readRoute(table, from, station);
+    if (leg.lengthMm == kNoRoute || leg.lengthMm >= nextMm) {
+      continue;
+    }
+    Route rest = readRoute(table, station, to);
+    if (rest.lengthMm != kNoRoute && (long)leg.lengthMm + rest.lengthMm == wholeMm) {
+      next = station;
+      nextMm = leg.lengthMm;
+    }
+  }
+  return next;
+}
+
+// Where the robot is once it has turned (if the plan says so) and faces
+// the way the route goes: still on its segment short of `from`, or at
+// `from` and heading for the route's next station
+template <unsigned int Stations>
+TrackPosition routeStart(const RouteTable<Stations> &table, const TrackPosition &position,
+                         const RoutePlan &plan) {
+  if (plan.approachMm <= 0) {
+    TrackPosition start = {plan.from, routeNextStation(table, plan.from, plan.to),
+                           -plan.approachMm};
+    return start;
+  }
+  if (!plan.turnAround) {
+    return position;
+  }
+  TrackPosition start = {
+    (unsigned char)(position.ahead ^ 1), (unsigned char)(position.behind ^ 1),
+    routeLengthMm(table, position.behind, position.ahead) - position.offsetMm
+  };
+  return start;
+}
+
+// Station of the `count`th marker on the route from -> to (from itself for
+// 0): the marked station that many markers along a shortest path
+template <unsigned int Stations>
+unsigned char routeMarkerStation(const RouteTable<Stations> &table, unsigned char from,
+                                 unsigned char to, unsigned char count) {
+  if (count == 0) {
+    return from;
+  }
+  Route whole = readRoute(table, from, to);
+  for (unsigned char station = 0; station < Stations; station++) {
+    Route leg = readRoute(table, from, station);
+    if (leg.lengthMm == kNoRoute || leg.markers != count || !leg.arriveByMarker) {
+      continue;
+    }
+    Route rest = readRoute(table, station, to);
+    if (rest.lengthMm != kNoRoute &&
+        (unsigned long)leg.lengthMm + rest.lengthMm == whole.lengthMm) {
+      return station;
+    }
+  }
+  return to;
+}
+
+// Walks a route as markers are crossed, handing out the branch to take
+class RouteFollower {
+public:
+  RouteFollower() : crossed(0), approachMm(0), approachMarker(false) {
+    route.lengthMm = 0;
+    route.markers = 0;
+    route.arriveByMarker = 1;
+    route.turns = 0;
+  }
+
+  // Begin a route; returns the branch to take on departure. With an
+  // approach, the robot first covers approachMm to the start (crossing its
+  // marker if approachMarker), and the departure branch waits for that.
+  TurnDirection start(const Route &newRoute, long newApproachMm = 0,
+                      bool newApproachMarker = false) {
+    route = newRoute;
+    crossed = 0;
+    approachMm = newApproachMm;
+    approachMarker = newApproachMarker;
+    return approachMarker ? TURN_STRAIGHT : turnAt(0);
+  }
+
+  // A marker was crossed; returns the branch to take from here
+  TurnDirection passMarker() {
+    if (approachMarker) {
+      approachMarker = false;
+    }
+    else if (crossed < route.markers) {
+      crossed++;
+    }
+    return turnAt(crossed);
+  }
+
+  // At a marked destination once its marker is crossed; otherwise after
+  // the last marker and the route's full length
+  bool arrived(long distanceMm) const {
+    if (approachMarker || crossed < route.markers) {
+      return false;
+    }
+    return route.arriveByMarker || distanceMm >= lengthMm();
+  }
+
+  // Still heading for the start of the route
+  bool approaching() const { return approachMarker; }
+
+  unsigned char markersCrossed() const { return crossed; }
+  unsigned char markersTotal() const { return route.markers; }
+  long lengthMm() const { return route.lengthMm + approachMm; }
+
+private:
+  Route route;
+  unsigned char crossed;
+  long approachMm;
+  bool approachMarker;
+
+  TurnDirection turnAt(unsigned char slot) const {
+    return slot < kMaxRouteDecisions
+         ? (TurnDirection)((route.turns >> (2 * slot)) & 0x03) : TURN_STRAIGHT;
+  }
+};
+
+#endif
@@ -0,0 +1,136 @@
+// Smart Waiter Robot - Line Sensor Calibration
+// Per-sensor min/max recorded during a calibration sweep, turned into
+// normalization coefficients so every sensor reads 0 (floor) to 1000 (line)
+// whatever its own range. The coefficients are small enough to keep in
+// EEPROM and are checked with a CRC when loaded.
+
+#ifndef SENSOR_CALIBRATION_H
+#define SENSOR_CALIBRATION_H
+
+#include "robot_protocol.h"
+
+const unsigned char kCalibrationSensors = 3;
+const unsigned char kCalibrationMagic = 0xCA;
+const unsigned char kCalibrationVersion = 1;
+
+// A sensor must swing at least this far (raw ADC counts) between floor and
+// line for the sweep to count
+const unsigned int kMinCalibrationSpan = 100;
+
+// Normalization scale is fixed point with 10 fractional bits
+const unsigned char kCalibrationScaleShift = 10;
+
+// EEPROM image. The line reads low, so darkness = (floor - raw) * scale.
+// All 16-bit fields so the layout (and the CRC) has no padding anywhere.
+struct StoredCalibration {
+  unsigned char magic;
+  unsigned char version;
+  unsigned short floor[kCalibrationSensors]; // Raw reading on bare floor
+  unsigned short scale[kCalibrationSensors]; // 1000 / (floor - line), Q10
+  unsigned short crc;
+};
+
+class SensorCalibration {
+public:
+  SensorCalibration() {
+    setDefaults();
+    beginSweep();
+  }
+
+  // Uncalibrated: full ADC range, same as the fixed mapping
+  void setDefaults() {
+    for (unsigned char i = 0; i < kCalibrationSensors; i++) {
+      coefficients.floor[i] = 1023;
+      coefficients.scale[i] = scaleFor(1023);
+    }
+    valid = false;
+  }
+
+  // Sweep: beginSweep(), addSample() for every round, then finishSweep()
+  void beginSweep() {
+    for (unsigned char i = 0; i < kCalibrationSensors; i++) {
+      minimum[i] = 1023;
+      maximum[i] = 0;
+    }
+  }
+
+  void addSample(const unsigned int raw[kCalibrationSensors]) {
+    for (unsigned char i = 0; i < kCalibrationSensors; i++) {
+      if (raw[i] < minimum[i]) minimum[i] = raw[i];
+      if (raw[i] > maximum[i]) maximum[i] = raw[i];
+    }
+  }
+
+  // Adopt the sweep if every sensor saw both floor and line. On failure the
+  // previous coefficients are kept.
+  bool finishSweep() {
+    for (unsigned char i = 0; i < kCalibrationSensors; i++) {
+      if (maximum[i] < minimum[i] + kMinCalibrationSpan) {
+        return false;
+      }
+    }
+    for (unsigned char i = 0; i < kCalibrationSensors; i++) {
+      coefficients.floor[i] = maximum[i];
+      coefficients.scale[i] = scaleFor(maximum[i] - minimum[i]);
+    }
+    valid = true;
+    return true;
+  }
+
+  // Raw 0-1023 readings to darkness 0 (floor) - 1000 (line)
+  void normalize(const unsigned int raw[kCalibrationSensors],
+                 int darkness[kCalibrationSensors]) const {
+    for (unsigned char i = 0; i < kCalibrationSensors; i++) {
+      long below = (long)coefficients.floor[i] - raw[i];
+      long value = below <= 0 ? 0
+                 : (below * coefficients.scale[i]) >> kCalibrationScaleShift;
+      darkness[i] = value > 1000 ? 1000 : (int)value;
+    }
+  }
+
+  bool isCalibrated() const { return valid; }
+  unsigned int sweepMinimum(unsigned char i) const { return minimum[i]; }
+  unsigned int sweepMaximum(unsigned char i) const { return maximum[i]; }
+
+  // EEPROM image with magic, version and CRC filled in
+  StoredCalibration stored() const {
+    StoredCalibration image = coefficients;
+    image.magic = kCalibrationMagic;
+    image.version = kCalibrationVersion;
+    image.crc = checksum(image);
+    return image;
+  }
+
+  // Use an EEPROM image if it is intact; returns false (and keeps the
+  // defaults) for a blank or corrupt EEPROM
+  bool load(const StoredCalibration &image) {
+    if (image.magic != kCalibrationMagic || image.version != kCalibrationVersion ||
+        image.crc != checksum(image)) {
+      return false;
+    }
+    for (unsigned char i = 0; i < kCalibrationSensors; i++) {
+      if (image.floor[i] > 1023 || image.scale[i] == 0) {
+        return false;
+      }
+    }
+    coefficients = image;
+    valid = true;
+    return true;
+  }
+
+private:
+  StoredCalibration coefficients;
+  bool valid;
+  unsigned int minimum[kCalibrationSensors];
+  unsigned int maximum[kCalibrationSensors];
+
+  static unsigned short scaleFor(unsigned int span) {
+    return (unsigned short)((1000UL << kCalibrationScaleShift) / span);
+  }
+
+  static unsigned short checksum(const StoredCalibration &image) {
+    return crc16((const unsigned char *)&image, sizeof(image) - sizeof(image.crc));
+  }
+};
+
+#endif
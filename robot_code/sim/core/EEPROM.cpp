@@ -0,0 +1,23 @@
+// Smart Waiter Robot - Host Arduino Core: EEPROM
+
+#include "EEPROM.h"
+
+#include "../host_board.h"
+
+EEPROMClass EEPROM;
+
+uint8_t EEPROMClass::read(int address) {
+  std::vector<uint8_t> &memory = sim::board().eeprom();
+  return address >= 0 && (size_t)address < memory.size() ? memory[address] : 0xFF;
+}
+
+void EEPROMClass::write(int address, uint8_t value) {
+  std::vector<uint8_t> &memory = sim::board().eeprom();
+  if (address >= 0 && (size_t)address < memory.size()) {
+    memory[address] = value;
+  }
+}
+
+uint16_t EEPROMClass::length() {
+  return (uint16_t)sim::board().eeprom().size();
+}
@@ -0,0 +1,41 @@
+// Smart Waiter Robot - Host Arduino Core: EEPROM
+// The Uno's 1 KB EEPROM, kept by the simulated board across resets.
+
+#ifndef EEPROM_h
+#define EEPROM_h
+
+#include <stdint.h>
+
+class EEPROMClass {
+public:
+  uint8_t read(int address);
+  void write(int address, uint8_t value);
+  void update(int address, uint8_t value) {
+    if (read(address) != value) {
+      write(address, value);
+    }
+  }
+  uint16_t length();
+
+  template <typename T>
+  T &get(int address, T &value) {
+    uint8_t *bytes = (uint8_t *)&value;
+    for (unsigned int i = 0; i < sizeof(T); i++) {
+      bytes[i] = read(address + (int)i);
+    }
+    return value;
+  }
+
+  template <typename T>
+  const T &put(int address, const T &value) {
+    const uint8_t *bytes = (const uint8_t *)&value;
+    for (unsigned int i = 0; i < sizeof(T); i++) {
+      update(address + (int)i, bytes[i]);
+    }
+    return value;
+  }
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
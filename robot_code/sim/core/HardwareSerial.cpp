@@ -0,0 +1,40 @@
+// Smart Waiter Robot - Host Arduino Core: HardwareSerial
+
+#include "HardwareSerial.h"
+
+#include "../host_board.h"
+
+HardwareSerial Serial;
+
+void HardwareSerial::begin(unsigned long baud, uint8_t config) {
+  (void)config;
+  sim::board().serial().begin(baud);
+}
+
+void HardwareSerial::end() {
+  flush();
+}
+
+int HardwareSerial::available() {
+  return sim::board().serial().available();
+}
+
+int HardwareSerial::peek() {
+  return sim::board().serial().peek();
+}
+
+int HardwareSerial::read() {
+  return sim::board().serial().read();
+}
+
+int HardwareSerial::availableForWrite() {
+  return sim::board().serial().availableForWrite();
+}
+
+void HardwareSerial::flush() {
+  sim::board().serial().flush();
+}
+
+size_t HardwareSerial::write(uint8_t byte) {
+  return sim::board().serial().write(byte);
+}
@@ -0,0 +1,30 @@
+// Smart Waiter Robot - Host Arduino Core: HardwareSerial
+// The USB serial port, backed by a virtual port of the simulated board.
+
+#ifndef HardwareSerial_h
+#define HardwareSerial_h
+
+#include "Stream.h"
+
+#define SERIAL_8N1 0x06
+
+class HardwareSerial : public Stream {
+public:
+  void begin(unsigned long baud) { begin(baud, SERIAL_8N1); }
+  void begin(unsigned long baud, uint8_t config);
+  void end();
+
+  virtual int available();
+  virtual int peek();
+  virtual int read();
+  virtual int availableForWrite();
+  virtual void flush();
+  virtual size_t write(uint8_t byte);
+  using Print::write;
+
+  operator bool() { return true; }
+};
+
+extern HardwareSerial Serial;
+
+#endif
@@ -0,0 +1,175 @@
+// Smart Waiter Robot - Host Arduino Core: Print
+// Number formatting follows the AVR core, so replies and logs read the same
+// as on the robot.
+
+#include "Print.h"
+
+#include <math.h>
+
+size_t Print::write(const uint8_t *buffer, size_t size) {
+  size_t n = 0;
+  while (size--) {
+    if (!write(*buffer++)) {
+      break;
+    }
+    n++;
+  }
+  return n;
+}
+
+size_t Print::print(const __FlashStringHelper *str) {
+  return write(reinterpret_cast<const char *>(str));
+}
+
+size_t Print::print(const String &str) {
+  return write(str.c_str(), str.length());
+}
+
+size_t Print::print(const char str[]) {
+  return write(str);
+}
+
+size_t Print::print(char c) {
+  return write((uint8_t)c);
+}
+
+size_t Print::print(unsigned char value, int base) {
+  return print((unsigned long)value, base);
+}
+
+size_t Print::print(int value, int base) {
+  return print((long)value, base);
+}
+
+size_t Print::print(unsigned int value, int base) {
+  return print((unsigned long)value, base);
+}
+
+size_t Print::print(long value, int base) {
+  if (base == 0) {
+    return write((uint8_t)value);
+  }
+  if (base == 10 && value < 0) {
+    size_t n = print('-');
+    return n + printNumber(0UL - (unsigned long)value, 10);
+  }
+  return printNumber((unsigned long)value, (uint8_t)base);
+}
+
+size_t Print::print(unsigned long value, int base) {
+  if (base == 0) {
+    return write((uint8_t)value);
+  }
+  return printNumber(value, (uint8_t)base);
+}
+
+size_t Print::print(double value, int digits) {
+  return printFloat(value, (uint8_t)digits);
+}
+
+size_t Print::println(const __FlashStringHelper *str) {
+  size_t n = print(str);
+  return n + println();
+}
+
+size_t Print::println(const String &str) {
+  size_t n = print(str);
+  return n + println();
+}
+
+size_t Print::println(const char str[]) {
+  size_t n = print(str);
+  return n + println();
+}
+
+size_t Print::println(char c) {
+  size_t n = print(c);
+  return n + println();
+}
+
+size_t Print::println(unsigned char value, int base) {
+  size_t n = print(value, base);
+  return n + println();
+}
+
+size_t Print::println(int value, int base) {
+  size_t n = print(value, base);
+  return n + println();
+}
+
+size_t Print::println(unsigned int value, int base) {
+  size_t n = print(value, base);
+  return n + println();
+}
+
+size_t Print::println(long value, int base) {
+  size_t n = print(value, base);
+  return n + println();
+}
+
+size_t Print::println(unsigned long value, int base) {
+  size_t n = print(value, base);
+  return n + println();
+}
+
+size_t Print::println(double value, int digits) {
+  size_t n = print(value, digits);
+  return n + println();
+}
+
+size_t Print::println(void) {
+  return write("\r\n");
+}
+
+size_t Print::printNumber(unsigned long value, uint8_t base) {
+  char text[8 * sizeof(unsigned long) + 1];
+  char *digit = &text[sizeof(text) - 1];
+  *digit = '\0';
+  if (base < 2) {
+    base = 10;
+  }
+  do {
+    char c = (char)(value % base);
+    value /= base;
+    *--digit = c < 10 ? c + '0' : c + 'A' - 10;
+  } while (value);
+  return write(digit);
+}
+
+size_t Print::printFloat(double value, uint8_t digits) {
+  if (isnan(value)) {
+    return print("nan");
+  }
+  if (isinf(value)) {
+    return print("inf");
+  }
+  if (value > 4294967040.0 || value < -4294967040.0) {
+    return print("ovf");
+  }
+
+  size_t n = 0;
+  if (value < 0.0) {
+    n += print('-');
+    value = -value;
+  }
+
+  double rounding = 0.5;
+  for (uint8_t i = 0; i < digits; i++) {
+    rounding /= 10.0;
+  }
+  value += rounding;
+
+  unsigned long whole = (unsigned long)value;
+  double remainder = value - (double)whole;
+  n += print(whole);
+  if (digits > 0) {
+    n += print('.');
+  }
+  while (digits-- > 0) {
+    remainder *= 10.0;
+    unsigned int digit = (unsigned int)remainder;
+    n += print(digit);
+    remainder -= digit;
+  }
+  return n;
+}
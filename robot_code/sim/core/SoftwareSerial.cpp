@@ -0,0 +1,41 @@
+// Smart Waiter Robot - Host Arduino Core: SoftwareSerial
+
+// Standard headers first: Arduino.h defines min() and max() as macros
+#include "../host_board.h"
+
+#include "SoftwareSerial.h"
+
+SoftwareSerial::SoftwareSerial(uint8_t receivePin, uint8_t transmitPin, bool inverseLogic)
+    : receivePin(receivePin), transmitPin(transmitPin), droppedSeen(0) {
+  (void)inverseLogic;
+}
+
+void SoftwareSerial::begin(long speed) {
+  sim::board().softwareSerial(receivePin).begin((unsigned long)speed);
+}
+
+// True once after bytes were lost to a full receive buffer
+bool SoftwareSerial::overflow() {
+  unsigned long dropped = sim::board().softwareSerial(receivePin).droppedBytes();
+  bool overflowed = dropped != droppedSeen;
+  droppedSeen = dropped;
+  return overflowed;
+}
+
+int SoftwareSerial::peek() {
+  return sim::board().softwareSerial(receivePin).peek();
+}
+
+int SoftwareSerial::read() {
+  return sim::board().softwareSerial(receivePin).read();
+}
+
+int SoftwareSerial::available() {
+  return sim::board().softwareSerial(receivePin).available();
+}
+
+void SoftwareSerial::flush() {}
+
+size_t SoftwareSerial::write(uint8_t byte) {
+  return sim::board().softwareSerial(receivePin).write(byte);
+}
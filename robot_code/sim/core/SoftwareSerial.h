@@ -0,0 +1,37 @@
+// Smart Waiter Robot - Host Arduino Core: SoftwareSerial
+// A bit-banged serial port, backed by a virtual port of the simulated
+// board (found by its RX pin). Writes hold the CPU for every byte, as the
+// AVR library does.
+
+#ifndef SoftwareSerial_h
+#define SoftwareSerial_h
+
+#include "Arduino.h"
+
+class SoftwareSerial : public Stream {
+public:
+  SoftwareSerial(uint8_t receivePin, uint8_t transmitPin, bool inverseLogic = false);
+
+  void begin(long speed);
+  bool listen() { return true; }
+  void end() {}
+  bool isListening() { return true; }
+  bool stopListening() { return true; }
+  bool overflow();
+
+  virtual int peek();
+  virtual int read();
+  virtual int available();
+  virtual void flush();
+  virtual size_t write(uint8_t byte);
+  using Print::write;
+
+  operator bool() { return true; }
+
+private:
+  uint8_t receivePin;
+  uint8_t transmitPin;
+  unsigned long droppedSeen;
+};
+
+#endif
@@ -0,0 +1,161 @@
+// Smart Waiter Robot - Host Arduino Core: Stream
+
+#include "Stream.h"
+
+#include "Arduino.h"
+
+int Stream::timedRead() {
+  unsigned long start = millis();
+  do {
+    int c = read();
+    if (c >= 0) {
+      return c;
+    }
+    delay(1);
+  } while (millis() - start < timeout);
+  return -1;
+}
+
+int Stream::timedPeek() {
+  unsigned long start = millis();
+  do {
+    int c = peek();
+    if (c >= 0) {
+      return c;
+    }
+    delay(1);
+  } while (millis() - start < timeout);
+  return -1;
+}
+
+int Stream::peekNextDigit(bool allowDot) {
+  while (true) {
+    int c = timedPeek();
+    if (c < 0 || c == '-' || (c >= '0' && c <= '9') || (allowDot && c == '.')) {
+      return c;
+    }
+    read();
+  }
+}
+
+bool Stream::find(const char *target) {
+  return findUntil(target, NULL);
+}
+
+bool Stream::findUntil(const char *target, const char *terminator) {
+  size_t length = strlen(target);
+  if (length == 0) {
+    return true;
+  }
+  size_t terminatorLength = terminator ? strlen(terminator) : 0;
+  size_t matched = 0;
+  size_t terminated = 0;
+  int c;
+  while ((c = timedRead()) >= 0) {
+    if (c == target[matched]) {
+      if (++matched >= length) {
+        return true;
+      }
+    } else {
+      matched = c == target[0] ? 1 : 0;
+    }
+    if (terminatorLength > 0) {
+      if (c == terminator[terminated]) {
+        if (++terminated >= terminatorLength) {
+          return false;
+        }
+      } else {
+        terminated = c == terminator[0] ? 1 : 0;
+      }
+    }
+  }
+  return false;
+}
+
+long Stream::parseInt() {
+  int c = peekNextDigit(false);
+  if (c < 0) {
+    return 0;
+  }
+  bool negative = false;
+  long value = 0;
+  do {
+    if (c == '-') {
+      negative = true;
+    } else if (c >= '0' && c <= '9') {
+      value = value * 10 + c - '0';
+    }
+    read();
+    c = timedPeek();
+  } while (c >= '0' && c <= '9');
+  return negative ? -value : value;
+}
+
+float Stream::parseFloat() {
+  int c = peekNextDigit(true);
+  if (c < 0) {
+    return 0;
+  }
+  bool negative = false;
+  bool fraction = false;
+  double value = 0;
+  double scale = 1;
+  do {
+    if (c == '-') {
+      negative = true;
+    } else if (c == '.') {
+      fraction = true;
+    } else {
+      value = value * 10 + c - '0';
+      if (fraction) {
+        scale *= 0.1;
+      }
+    }
+    read();
+    c = timedPeek();
+  } while ((c >= '0' && c <= '9') || (c == '.' && !fraction));
+  value *= scale;
+  return (float)(negative ? -value : value);
+}
+
+size_t Stream::readBytes(char *buffer, size_t length) {
+  size_t count = 0;
+  while (count < length) {
+    int c = timedRead();
+    if (c < 0) {
+      break;
+    }
+    buffer[count++] = (char)c;
+  }
+  return count;
+}
+
+size_t Stream::readBytesUntil(char terminator, char *buffer, size_t length) {
+  size_t count = 0;
+  while (count < length) {
+    int c = timedRead();
+    if (c < 0 || c == terminator) {
+      break;
+    }
+    buffer[count++] = (char)c;
+  }
+  return count;
+}
+
+String Stream::readString() {
+  String out;
+  int c;
+  while ((c = timedRead()) >= 0) {
+    out += (char)c;
+  }
+  return out;
+}
+
+String Stream::readStringUntil(char terminator) {
+  String out;
+  int c;
+  while ((c = timedRead()) >= 0 && c != terminator) {
+    out += (char)c;
+  }
+  return out;
+}
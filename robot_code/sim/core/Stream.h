@@ -0,0 +1,42 @@
+// Smart Waiter Robot - Host Arduino Core: Stream
+// Reads with a timeout (readStringUntil and friends) wait on the virtual
+// clock, so a missing terminator costs simulated time, not real time.
+
+#ifndef Stream_h
+#define Stream_h
+
+#include "Print.h"
+
+class Stream : public Print {
+public:
+  Stream() : timeout(1000) {}
+
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+
+  void setTimeout(unsigned long milliseconds) { timeout = milliseconds; }
+  unsigned long getTimeout() const { return timeout; }
+
+  bool find(const char *target);
+  // Like find(), but gives up early at terminator
+  bool findUntil(const char *target, const char *terminator);
+  long parseInt();
+  float parseFloat();
+  size_t readBytes(char *buffer, size_t length);
+  size_t readBytes(uint8_t *buffer, size_t length) { return readBytes((char *)buffer, length); }
+  size_t readBytesUntil(char terminator, char *buffer, size_t length);
+  String readString();
+  String readStringUntil(char terminator);
+
+protected:
+  unsigned long timeout;
+
+  // Next byte, or -1 once the timeout has passed
+  int timedRead();
+  int timedPeek();
+  // Skip to the next character that can start a number
+  int peekNextDigit(bool allowDot);
+};
+
+#endif
@@ -0,0 +1,563 @@
+// Smart Waiter Robot - Host Arduino Core: String
+// Every buffer change is reported to the board's heap statistics.
+
+// Before Arduino.h, whose min/max macros break the standard headers
+#include "../host_board.h"
+
+#include "WString.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <utility>
+
+namespace {
+
+// Digits of value in base 2-36, like the AVR core's ultoa()
+void unsignedToText(unsigned long value, unsigned char base, char *out) {
+  char digits[8 * sizeof(unsigned long) + 1];
+  unsigned int count = 0;
+  if (base < 2 || base > 36) {
+    base = 10;
+  }
+  do {
+    unsigned int digit = value % base;
+    digits[count++] = (char)(digit < 10 ? '0' + digit : 'a' + digit - 10);
+    value /= base;
+  } while (value != 0);
+  while (count > 0) {
+    *out++ = digits[--count];
+  }
+  *out = '\0';
+}
+
+void signedToText(long value, unsigned char base, char *out) {
+  if (value < 0 && base == 10) {
+    *out++ = '-';
+    unsignedToText(0UL - (unsigned long)value, base, out);
+  } else {
+    unsignedToText((unsigned long)value, base, out);
+  }
+}
+
+}  // namespace
+
+String::String(const char *cstr) : buffer(NULL), capacity(0), len(0) {
+  if (cstr) {
+    copy(cstr, (unsigned int)strlen(cstr));
+  }
+}
+
+String::String(const String &str) : buffer(NULL), capacity(0), len(0) {
+  *this = str;
+}
+
+String::String(String &&rval) : buffer(NULL), capacity(0), len(0) {
+  move(rval);
+}
+
+String::String(const __FlashStringHelper *str) : buffer(NULL), capacity(0), len(0) {
+  const char *cstr = reinterpret_cast<const char *>(str);
+  if (cstr) {
+    copy(cstr, (unsigned int)strlen(cstr));
+  }
+}
+
+String::String(char c) : buffer(NULL), capacity(0), len(0) {
+  char text[2] = {c, '\0'};
+  copy(text, 1);
+}
+
+String::String(unsigned char value, unsigned char base) : buffer(NULL), capacity(0), len(0) {
+  char text[1 + 8 * sizeof(unsigned char)];
+  unsignedToText(value, base, text);
+  *this = text;
+}
+
+String::String(int value, unsigned char base) : buffer(NULL), capacity(0), len(0) {
+  char text[2 + 8 * sizeof(int)];
+  signedToText(value, base, text);
+  *this = text;
+}
+
+String::String(unsigned int value, unsigned char base) : buffer(NULL), capacity(0), len(0) {
+  char text[1 + 8 * sizeof(unsigned int)];
+  unsignedToText(value, base, text);
+  *this = text;
+}
+
+String::String(long value, unsigned char base) : buffer(NULL), capacity(0), len(0) {
+  char text[2 + 8 * sizeof(long)];
+  signedToText(value, base, text);
+  *this = text;
+}
+
+String::String(unsigned long value, unsigned char base) : buffer(NULL), capacity(0), len(0) {
+  char text[1 + 8 * sizeof(unsigned long)];
+  unsignedToText(value, base, text);
+  *this = text;
+}
+
+String::String(float value, unsigned char decimalPlaces) : buffer(NULL), capacity(0), len(0) {
+  char text[48];
+  snprintf(text, sizeof(text), "%.*f", decimalPlaces, (double)value);
+  *this = text;
+}
+
+String::String(double value, unsigned char decimalPlaces) : buffer(NULL), capacity(0), len(0) {
+  char text[48];
+  snprintf(text, sizeof(text), "%.*f", decimalPlaces, value);
+  *this = text;
+}
+
+String::~String() {
+  invalidate();
+}
+
+void String::invalidate() {
+  if (buffer) {
+    sim::board().noteHeap(capacity + 1, 0);
+  }
+  if (onHeap()) {
+    free(buffer);
+  }
+  buffer = NULL;
+  capacity = len = 0;
+}
+
+// Take over rhs's text and its place in the heap statistics, leaving rhs
+// empty. Nothing is allocated or freed, as with the AVR core's move.
+void String::move(String &rhs) {
+  invalidate();
+  if (!rhs.buffer) {
+    return;
+  }
+  if (rhs.onHeap()) {
+    buffer = rhs.buffer;
+  } else {
+    memcpy(inlineBuffer, rhs.inlineBuffer, rhs.len + 1);
+    buffer = inlineBuffer;
+  }
+  capacity = rhs.capacity;
+  len = rhs.len;
+  rhs.buffer = NULL;
+  rhs.capacity = rhs.len = 0;
+}
+
+bool String::reserve(unsigned int size) {
+  if (buffer && capacity >= size) {
+    return true;
+  }
+  if (changeBuffer(size)) {
+    if (len == 0) {
+      buffer[0] = '\0';
+    }
+    return true;
+  }
+  return false;
+}
+
+// Only ever grows. Stays inline while the text fits, then moves to the heap.
+bool String::changeBuffer(unsigned int maxStrLen) {
+  char *newBuffer;
+  if (maxStrLen <= kInlineCapacity) {
+    newBuffer = inlineBuffer;
+  } else if (onHeap()) {
+    newBuffer = (char *)realloc(buffer, maxStrLen + 1);
+  } else {
+    newBuffer = (char *)malloc(maxStrLen + 1);
+    if (newBuffer && buffer) {
+      memcpy(newBuffer, buffer, len + 1);
+    }
+  }
+  if (!newBuffer) {
+    return false;
+  }
+  sim::board().noteHeap(buffer ? capacity + 1 : 0, maxStrLen + 1);
+  buffer = newBuffer;
+  capacity = maxStrLen;
+  return true;
+}
+
+String &String::copy(const char *cstr, unsigned int length) {
+  if (!reserve(length)) {
+    invalidate();
+    return *this;
+  }
+  len = length;
+  memmove(buffer, cstr, length);
+  buffer[length] = '\0';
+  return *this;
+}
+
+String &String::operator=(const String &rhs) {
+  if (this == &rhs) {
+    return *this;
+  }
+  if (rhs.buffer) {
+    copy(rhs.buffer, rhs.len);
+  } else {
+    invalidate();
+  }
+  return *this;
+}
+
+String &String::operator=(String &&rval) {
+  if (this != &rval) {
+    move(rval);
+  }
+  return *this;
+}
+
+String &String::operator=(const char *cstr) {
+  if (cstr) {
+    copy(cstr, (unsigned int)strlen(cstr));
+  } else {
+    invalidate();
+  }
+  return *this;
+}
+
+bool String::concat(const char *cstr, unsigned int length) {
+  if (!cstr) {
+    return false;
+  }
+  if (length == 0) {
+    return true;
+  }
+  unsigned int newLen = len + length;
+  if (!reserve(newLen)) {
+    return false;
+  }
+  memmove(buffer + len, cstr, length);
+  len = newLen;
+  buffer[len] = '\0';
+  return true;
+}
+
+bool String::concat(const String &str) {
+  return concat(str.c_str(), str.len);
+}
+
+bool String::concat(const char *cstr) {
+  return cstr ? concat(cstr, (unsigned int)strlen(cstr)) : false;
+}
+
+bool String::concat(char c) {
+  return concat(&c, 1);
+}
+
+// Numbers are formatted on the stack, as the AVR core does, so appending
+// one allocates no more than appending its text
+bool String::concat(unsigned char num) {
+  return concat((unsigned long)num);
+}
+
+bool String::concat(int num) {
+  return concat((long)num);
+}
+
+bool String::concat(unsigned int num) {
+  return concat((unsigned long)num);
+}
+
+bool String::concat(long num) {
+  char text[2 + 8 * sizeof(long)];
+  signedToText(num, 10, text);
+  return concat(text, (unsigned int)strlen(text));
+}
+
+bool String::concat(unsigned long num) {
+  char text[1 + 8 * sizeof(unsigned long)];
+  unsignedToText(num, 10, text);
+  return concat(text, (unsigned int)strlen(text));
+}
+
+bool String::concat(float num) {
+  return concat((double)num);
+}
+
+bool String::concat(double num) {
+  char text[48];
+  snprintf(text, sizeof(text), "%.2f", num);
+  return concat(text, (unsigned int)strlen(text));
+}
+
+int String::compareTo(const String &s) const {
+  return strcmp(c_str(), s.c_str());
+}
+
+bool String::equals(const String &s) const {
+  return len == s.len && compareTo(s) == 0;
+}
+
+bool String::equals(const char *cstr) const {
+  return strcmp(c_str(), cstr ? cstr : "") == 0;
+}
+
+bool String::equalsIgnoreCase(const String &s) const {
+  if (len != s.len) {
+    return false;
+  }
+  for (unsigned int i = 0; i < len; i++) {
+    if (tolower((unsigned char)buffer[i]) != tolower((unsigned char)s.buffer[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool String::startsWith(const String &prefix) const {
+  return len >= prefix.len && startsWith(prefix, 0);
+}
+
+bool String::startsWith(const String &prefix, unsigned int offset) const {
+  if (offset > len || prefix.len > len - offset) {
+    return false;
+  }
+  return strncmp(c_str() + offset, prefix.c_str(), prefix.len) == 0;
+}
+
+bool String::endsWith(const String &suffix) const {
+  if (len < suffix.len) {
+    return false;
+  }
+  return strcmp(c_str() + len - suffix.len, suffix.c_str()) == 0;
+}
+
+char String::charAt(unsigned int index) const {
+  return operator[](index);
+}
+
+void String::setCharAt(unsigned int index, char c) {
+  if (index < len) {
+    buffer[index] = c;
+  }
+}
+
+char String::operator[](unsigned int index) const {
+  return index < len ? buffer[index] : '\0';
+}
+
+char &String::operator[](unsigned int index) {
+  static char dummy;
+  if (index >= len) {
+    dummy = '\0';
+    return dummy;
+  }
+  return buffer[index];
+}
+
+void String::toCharArray(char *buf, unsigned int bufsize, unsigned int index) const {
+  if (bufsize == 0 || !buf) {
+    return;
+  }
+  if (index >= len) {
+    buf[0] = '\0';
+    return;
+  }
+  unsigned int n = bufsize - 1;
+  if (n > len - index) {
+    n = len - index;
+  }
+  memcpy(buf, buffer + index, n);
+  buf[n] = '\0';
+}
+
+int String::indexOf(char ch) const {
+  return indexOf(ch, 0);
+}
+
+int String::indexOf(char ch, unsigned int fromIndex) const {
+  if (fromIndex >= len) {
+    return -1;
+  }
+  const char *found = (const char *)memchr(buffer + fromIndex, ch, len - fromIndex);
+  return found ? (int)(found - buffer) : -1;
+}
+
+int String::indexOf(const String &str) const {
+  return indexOf(str, 0);
+}
+
+int String::indexOf(const String &str, unsigned int fromIndex) const {
+  if (fromIndex >= len) {
+    return -1;
+  }
+  const char *found = strstr(buffer + fromIndex, str.c_str());
+  return found ? (int)(found - buffer) : -1;
+}
+
+int String::lastIndexOf(char ch) const {
+  const char *found = len ? strrchr(buffer, ch) : NULL;
+  return found ? (int)(found - buffer) : -1;
+}
+
+int String::lastIndexOf(const String &str) const {
+  if (str.len > len) {
+    return -1;
+  }
+  for (int i = (int)(len - str.len); i >= 0; i--) {
+    if (strncmp(buffer + i, str.c_str(), str.len) == 0) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+String String::substring(unsigned int beginIndex) const {
+  return substring(beginIndex, len);
+}
+
+String String::substring(unsigned int beginIndex, unsigned int endIndex) const {
+  if (beginIndex > endIndex) {
+    unsigned int swap = beginIndex;
+    beginIndex = endIndex;
+    endIndex = swap;
+  }
+  String out;
+  if (beginIndex >= len) {
+    return out;
+  }
+  if (endIndex > len) {
+    endIndex = len;
+  }
+  out.copy(buffer + beginIndex, endIndex - beginIndex);
+  return out;
+}
+
+void String::replace(char find, char replace) {
+  for (unsigned int i = 0; i < len; i++) {
+    if (buffer[i] == find) {
+      buffer[i] = replace;
+    }
+  }
+}
+
+void String::replace(const String &find, const String &replace) {
+  if (len == 0 || find.len == 0) {
+    return;
+  }
+  String out;
+  unsigned int pos = 0;
+  int found;
+  while ((found = indexOf(find, pos)) >= 0) {
+    out.concat(buffer + pos, (unsigned int)found - pos);
+    out.concat(replace);
+    pos = (unsigned int)found + find.len;
+  }
+  out.concat(buffer + pos, len - pos);
+  *this = std::move(out);
+}
+
+void String::remove(unsigned int index) {
+  remove(index, (unsigned int)-1);
+}
+
+void String::remove(unsigned int index, unsigned int count) {
+  if (index >= len) {
+    return;
+  }
+  if (count > len - index) {
+    count = len - index;
+  }
+  memmove(buffer + index, buffer + index + count, len - index - count);
+  len -= count;
+  buffer[len] = '\0';
+}
+
+void String::toLowerCase() {
+  for (unsigned int i = 0; i < len; i++) {
+    buffer[i] = (char)tolower((unsigned char)buffer[i]);
+  }
+}
+
+void String::toUpperCase() {
+  for (unsigned int i = 0; i < len; i++) {
+    buffer[i] = (char)toupper((unsigned char)buffer[i]);
+  }
+}
+
+void String::trim() {
+  if (len == 0) {
+    return;
+  }
+  unsigned int begin = 0;
+  while (begin < len && isspace((unsigned char)buffer[begin])) {
+    begin++;
+  }
+  unsigned int end = len;
+  while (end > begin && isspace((unsigned char)buffer[end - 1])) {
+    end--;
+  }
+  len = end - begin;
+  if (begin > 0) {
+    memmove(buffer, buffer + begin, len);
+  }
+  buffer[len] = '\0';
+}
+
+long String::toInt() const {
+  return atol(c_str());
+}
+
+float String::toFloat() const {
+  return (float)atof(c_str());
+}
+
+double String::toDouble() const {
+  return atof(c_str());
+}
+
+String operator+(String lhs, const String &rhs) {
+  lhs.concat(rhs);
+  return lhs;
+}
+
+String operator+(String lhs, const char *rhs) {
+  lhs.concat(rhs);
+  return lhs;
+}
+
+String operator+(const char *lhs, const String &rhs) {
+  String out(lhs);
+  out.concat(rhs);
+  return out;
+}
+
+String operator+(String lhs, char rhs) {
+  lhs.concat(rhs);
+  return lhs;
+}
+
+String operator+(String lhs, int rhs) {
+  lhs.concat(rhs);
+  return lhs;
+}
+
+String operator+(String lhs, unsigned int rhs) {
+  lhs.concat(rhs);
+  return lhs;
+}
+
+String operator+(String lhs, long rhs) {
+  lhs.concat(rhs);
+  return lhs;
+}
+
+String operator+(String lhs, unsigned long rhs) {
+  lhs.concat(rhs);
+  return lhs;
+}
+
+String operator+(String lhs, float rhs) {
+  lhs.concat(rhs);
+  return lhs;
+}
+
+String operator+(String lhs, double rhs) {
+  lhs.concat(rhs);
+  return lhs;
+}
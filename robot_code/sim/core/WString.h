@@ -0,0 +1,134 @@
+// Smart Waiter Robot - Host Arduino Core: String
+// String with the Arduino WString interface. Text of up to
+// kInlineCapacity characters is kept inside the object, longer text on the
+// heap, and a temporary (a substring(), the result of +) is moved rather
+// than copied.
+//
+// The board's heap statistics (host_board.h) still count what the AVR
+// String would allocate, which has no inline buffer: a short String is one
+// allocation there even though it costs none here, so the heap check in
+// the simulator stays as strict as the robot.
+
+#ifndef String_class_h
+#define String_class_h
+
+#include <stddef.h>
+
+#include "avr/pgmspace.h"
+
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(PSTR(string_literal)))
+
+class String {
+public:
+  String(const char *cstr = "");
+  String(const String &str);
+  String(String &&rval);
+  String(const __FlashStringHelper *str);
+  explicit String(char c);
+  explicit String(unsigned char value, unsigned char base = 10);
+  explicit String(int value, unsigned char base = 10);
+  explicit String(unsigned int value, unsigned char base = 10);
+  explicit String(long value, unsigned char base = 10);
+  explicit String(unsigned long value, unsigned char base = 10);
+  explicit String(float value, unsigned char decimalPlaces = 2);
+  explicit String(double value, unsigned char decimalPlaces = 2);
+  ~String();
+
+  String &operator=(const String &rhs);
+  String &operator=(String &&rval);
+  String &operator=(const char *cstr);
+
+  // Grow the buffer ahead of appends; false if out of memory
+  bool reserve(unsigned int size);
+  unsigned int length() const { return len; }
+  const char *c_str() const { return buffer ? buffer : ""; }
+
+  bool concat(const String &str);
+  bool concat(const char *cstr);
+  bool concat(const char *cstr, unsigned int length);
+  bool concat(char c);
+  bool concat(unsigned char num);
+  bool concat(int num);
+  bool concat(unsigned int num);
+  bool concat(long num);
+  bool concat(unsigned long num);
+  bool concat(float num);
+  bool concat(double num);
+
+  template <typename T>
+  String &operator+=(const T &rhs) {
+    concat(rhs);
+    return *this;
+  }
+
+  int compareTo(const String &s) const;
+  bool equals(const String &s) const;
+  bool equals(const char *cstr) const;
+  bool equalsIgnoreCase(const String &s) const;
+  bool operator==(const String &rhs) const { return equals(rhs); }
+  bool operator==(const char *cstr) const { return equals(cstr); }
+  bool operator!=(const String &rhs) const { return !equals(rhs); }
+  bool operator!=(const char *cstr) const { return !equals(cstr); }
+  bool operator<(const String &rhs) const { return compareTo(rhs) < 0; }
+  bool operator>(const String &rhs) const { return compareTo(rhs) > 0; }
+  bool startsWith(const String &prefix) const;
+  bool startsWith(const String &prefix, unsigned int offset) const;
+  bool endsWith(const String &suffix) const;
+
+  char charAt(unsigned int index) const;
+  void setCharAt(unsigned int index, char c);
+  char operator[](unsigned int index) const;
+  char &operator[](unsigned int index);
+  void toCharArray(char *buf, unsigned int bufsize, unsigned int index = 0) const;
+
+  int indexOf(char ch) const;
+  int indexOf(char ch, unsigned int fromIndex) const;
+  int indexOf(const String &str) const;
+  int indexOf(const String &str, unsigned int fromIndex) const;
+  int lastIndexOf(char ch) const;
+  int lastIndexOf(const String &str) const;
+  String substring(unsigned int beginIndex) const;
+  String substring(unsigned int beginIndex, unsigned int endIndex) const;
+
+  void replace(char find, char replace);
+  void replace(const String &find, const String &replace);
+  void remove(unsigned int index);
+  void remove(unsigned int index, unsigned int count);
+  void toLowerCase();
+  void toUpperCase();
+  void trim();
+
+  long toInt() const;
+  float toFloat() const;
+  double toDouble() const;
+
+  static const unsigned int kInlineCapacity = 23;
+
+private:
+  char *buffer;        // NULL, inlineBuffer or a heap block
+  unsigned int capacity;
+  unsigned int len;
+  char inlineBuffer[kInlineCapacity + 1];
+
+  bool onHeap() const { return buffer && buffer != inlineBuffer; }
+  void invalidate();
+  void move(String &rhs);
+  bool changeBuffer(unsigned int maxStrLen);
+  String &copy(const char *cstr, unsigned int length);
+};
+
+// lhs is taken by value, so in a + b + c the temporary a + b is appended
+// to rather than copied
+String operator+(String lhs, const String &rhs);
+String operator+(String lhs, const char *rhs);
+String operator+(const char *lhs, const String &rhs);
+String operator+(String lhs, char rhs);
+String operator+(String lhs, int rhs);
+String operator+(String lhs, unsigned int rhs);
+String operator+(String lhs, long rhs);
+String operator+(String lhs, unsigned long rhs);
+String operator+(String lhs, float rhs);
+String operator+(String lhs, double rhs);
+
+#endif
@@ -0,0 +1,21 @@
+// Smart Waiter Robot - Host Arduino Core: Program Memory
+// Flash is ordinary memory on the host, so the pgm_read_* macros just
+// dereference. PROGMEM data still goes into a section of its own,
+// .progmem.data as on the AVR, so the size report (sim/size_report.py) can
+// tell it apart from constants the AVR build copies into RAM.
+
+#ifndef __PGMSPACE_H_
+#define __PGMSPACE_H_ 1
+
+#include <string.h>
+
+#define PROGMEM __attribute__((section(".progmem.data")))
+#define PSTR(s) (__extension__({ static const char __c[] PROGMEM = (s); &__c[0]; }))
+
+#define pgm_read_byte(address) (*(const unsigned char *)(address))
+#define pgm_read_word(address) (*(const unsigned short *)(address))
+#define pgm_read_dword(address) (*(const unsigned long *)(address))
+
+#define strlen_P(s) strlen(s)
+
+#endif
@@ -0,0 +1,93 @@
+// Smart Waiter Robot - Host Arduino Core: pins, time and interrupts
+
+// Standard headers first: Arduino.h defines min() and max() as macros
+#include "../host_board.h"
+
+#include "Arduino.h"
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  sim::board().setPinMode(pin, mode);
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+  sim::board().writePin(pin, val ? HIGH : LOW);
+}
+
+int digitalRead(uint8_t pin) {
+  return sim::board().readPin(pin) ? HIGH : LOW;
+}
+
+// Conversions are instant; the AVR's ~110 us per read is not charged,
+// since the firmware samples in the background (adc_sampler.h)
+int analogRead(uint8_t pin) {
+  if (pin < A0) {
+    pin += A0;
+  }
+  int value = sim::board().readAnalog(pin);
+  return value < 0 ? 0 : (value > 1023 ? 1023 : value);
+}
+
+void analogWrite(uint8_t pin, int val) {
+  sim::board().writePin(pin, val < 0 ? 0 : (val > 255 ? 255 : val));
+}
+
+unsigned long millis(void) {
+  return (unsigned long)(sim::board().micros() / 1000);
+}
+
+unsigned long micros(void) {
+  return (unsigned long)sim::board().micros();
+}
+
+void delay(unsigned long ms) {
+  sim::board().advance((uint64_t)ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us) {
+  sim::board().advance(us);
+}
+
+void attachInterrupt(uint8_t interruptNum, void (*userFunc)(void), int mode) {
+  (void)mode;
+  sim::board().attachInterrupt(interruptNum, userFunc);
+}
+
+void detachInterrupt(uint8_t interruptNum) {
+  sim::board().detachInterrupt(interruptNum);
+}
+
+void interrupts(void) {
+  sim::board().setInterruptsEnabled(true);
+}
+
+void noInterrupts(void) {
+  sim::board().setInterruptsEnabled(false);
+}
+
+// Same generator on every run, so simulations repeat exactly
+static unsigned long randomState = 1;
+
+void randomSeed(unsigned long seed) {
+  if (seed != 0) {
+    randomState = seed;
+  }
+}
+
+long random(long howBig) {
+  if (howBig <= 0) {
+    return 0;
+  }
+  randomState = randomState * 1103515245UL + 12345UL;
+  return (long)((randomState >> 16) % (unsigned long)howBig);
+}
+
+long random(long howSmall, long howBig) {
+  if (howSmall >= howBig) {
+    return howSmall;
+  }
+  return random(howBig - howSmall) + howSmall;
+}
+
+long map(long value, long fromLow, long fromHigh, long toLow, long toHigh) {
+  return (value - fromLow) * (toHigh - toLow) / (fromHigh - fromLow) + toLow;
+}
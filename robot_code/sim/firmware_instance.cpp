@@ -0,0 +1,91 @@
+// Smart Waiter Robot - Firmware Instances
+
+#include "firmware_instance.h"
+
+#include <dlfcn.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <fstream>
+
+namespace sim {
+
+namespace {
+
+// A private copy of the file in the temporary directory; empty on failure
+std::string copyModule(const std::string &path, std::string &error) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    error = "cannot open " + path;
+    return std::string();
+  }
+  const char *dir = getenv("TMPDIR");
+  std::string copy = std::string(dir && *dir ? dir : "/tmp") + "/waiter_firmware_XXXXXX";
+  int fd = mkstemp(&copy[0]);
+  if (fd < 0) {
+    error = "cannot create " + copy;
+    return std::string();
+  }
+  char buffer[65536];
+  bool ok = true;
+  while (ok && in) {
+    in.read(buffer, sizeof(buffer));
+    const char *data = buffer;
+    std::streamsize left = in.gcount();
+    while (ok && left > 0) {
+      ssize_t written = write(fd, data, (size_t)left);
+      ok = written > 0;
+      data += written;
+      left -= written;
+    }
+  }
+  close(fd);
+  if (!ok) {
+    unlink(copy.c_str());
+    error = "cannot write " + copy;
+    return std::string();
+  }
+  return copy;
+}
+
+void appendLog(void *context, const char *text, size_t length) {
+  static_cast<std::string *>(context)->append(text, length);
+}
+
+}  // namespace
+
+FirmwareInstance::FirmwareInstance(const std::string &modulePath) {
+  std::string copy = copyModule(modulePath, error_);
+  if (copy.empty()) {
+    return;
+  }
+  handle_ = dlopen(copy.c_str(), RTLD_NOW | RTLD_LOCAL);
+  unlink(copy.c_str());
+  if (!handle_) {
+    error_ = dlerror();
+    return;
+  }
+  run_ = reinterpret_cast<WaiterRunFunction>(dlsym(handle_, WAITER_RUN_SYMBOL));
+  if (!run_) {
+    error_ = modulePath + " is not a firmware module";
+  }
+}
+
+FirmwareInstance::~FirmwareInstance() {
+  if (handle_) {
+    dlclose(handle_);
+  }
+}
+
+WaiterRunResult FirmwareInstance::run(const WaiterRunOptions &options, std::string &log) {
+  WaiterRunResult result = {2, 0, 0};
+  if (run_) {
+    run_(&options, appendLog, &log, &result);
+    run_ = nullptr;
+  } else {
+    log += error_.empty() ? "instance already used\n" : error_ + "\n";
+  }
+  return result;
+}
+
+}  // namespace sim
@@ -0,0 +1,40 @@
+// Smart Waiter Robot - Firmware Instances
+// One simulated robot per loaded copy of waiter_firmware_module
+// (firmware_module.h). The module file is copied before loading, since the
+// loader hands out the copy it already has for a file it has seen, and the
+// copy is deleted again once mapped. Instances share nothing, so they can
+// run side by side on different threads, each on its own clock.
+
+#ifndef SIM_FIRMWARE_INSTANCE_H
+#define SIM_FIRMWARE_INSTANCE_H
+
+#include <string>
+
+#include "firmware_module.h"
+
+namespace sim {
+
+class FirmwareInstance {
+public:
+  explicit FirmwareInstance(const std::string &modulePath);
+  ~FirmwareInstance();
+
+  FirmwareInstance(const FirmwareInstance &) = delete;
+  FirmwareInstance &operator=(const FirmwareInstance &) = delete;
+
+  // Loaded and not run yet
+  bool ready() const { return run_ != nullptr; }
+  const std::string &error() const { return error_; }
+
+  // Power on and play the script (once per instance); the log is appended
+  WaiterRunResult run(const WaiterRunOptions &options, std::string &log);
+
+private:
+  void *handle_ = nullptr;
+  WaiterRunFunction run_ = nullptr;
+  std::string error_;
+};
+
+}  // namespace sim
+
+#endif
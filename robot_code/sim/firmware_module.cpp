@@ -0,0 +1,53 @@
+// Smart Waiter Robot - Firmware Module
+// Entry point of waiter_firmware_module (firmware_module.h). Everything
+// else in the module is hidden, so each loaded copy binds to its own sketch
+// and board.
+
+#include "firmware_module.h"
+
+#include <sstream>
+#include <string>
+
+#include "script_runner.h"
+#include "simulation.h"
+#include "track_map.h"
+
+extern "C" __attribute__((visibility("default"))) int waiter_module_run(
+    const WaiterRunOptions *options, WaiterLogWriter log, void *context,
+    WaiterRunResult *result) {
+  std::ostringstream out;
+  sim::TrackMap track;
+  std::string error;
+  bool mapLoaded;
+  if (options->map) {
+    std::istringstream map(options->map);
+    mapLoaded = track.load(map, error);
+  } else {
+    mapLoaded = sim::layoutTrack(track, error);
+  }
+
+  *result = WaiterRunResult{2, 0, 0};
+  if (!mapLoaded) {
+    out << "map: " << error << '\n';
+  } else {
+    sim::RobotParameters parameters;
+    parameters.sensorNoise = options->sensorNoise;
+    parameters.noiseSeed = options->noiseSeed;
+    sim::Simulation simulation(track, parameters);
+    if (options->stepMicros) {
+      simulation.setStepMicros(options->stepMicros);
+    }
+    sim::ScriptRunner runner(simulation, out);
+    runner.setShowSerial(options->showSerial != 0);
+    std::istringstream script(options->script ? options->script : "");
+    result->status = runner.run(script) ? 0 : 1;
+    result->micros = simulation.micros();
+    result->travelledMm = simulation.robot().travelledMm();
+  }
+
+  if (log) {
+    std::string text = out.str();
+    log(context, text.data(), text.size());
+  }
+  return result->status;
+}
@@ -0,0 +1,44 @@
+// Smart Waiter Robot - Firmware Module Interface
+// waiter_firmware_module is the firmware, host core, board and robot model
+// built as one loadable module. The sketch keeps its state in globals, so
+// one process can only hold one robot - unless it loads the module several
+// times: every copy (firmware_instance.h) has its own sketch globals and
+// its own board with its own clock. This is the only way in, kept to plain
+// C so nothing but these structs crosses between copies.
+
+#ifndef SIM_FIRMWARE_MODULE_H
+#define SIM_FIRMWARE_MODULE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+extern "C" {
+
+struct WaiterRunOptions {
+  const char *map;      // Map file text (track_map.h); null for the layout
+  const char *script;   // script_runner.h
+  int sensorNoise;
+  uint32_t noiseSeed;
+  uint64_t stepMicros;  // 0 for the default
+  int showSerial;
+};
+
+struct WaiterRunResult {
+  int status;           // 0 passed, 1 an `until` timed out, 2 bad map
+  uint64_t micros;      // Simulated time at the end
+  double travelledMm;
+};
+
+// The log comes back in one call at the end of the run
+typedef void (*WaiterLogWriter)(void *context, const char *text, size_t length);
+
+// Power the robot on and play the script. Once per loaded copy: the
+// sketch's globals are not reset.
+typedef int (*WaiterRunFunction)(const WaiterRunOptions *options, WaiterLogWriter log,
+                                 void *context, WaiterRunResult *result);
+
+}
+
+#define WAITER_RUN_SYMBOL "waiter_module_run"
+
+#endif
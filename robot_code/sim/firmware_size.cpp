@@ -0,0 +1,14 @@
+// Smart Waiter Robot - Firmware Size Build
+// Entry point of the per-variant size builds (sim/size_report.py). It only
+// calls the sketch, so the linker keeps what the firmware uses and drops
+// the rest. Never run.
+
+void setup();
+void loop();
+
+int main() {
+  setup();
+  for (;;) {
+    loop();
+  }
+}
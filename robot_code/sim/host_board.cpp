@@ -0,0 +1,237 @@
+// Smart Waiter Robot - Simulated Board
+
+#include "host_board.h"
+
+#include <algorithm>
+
+namespace sim {
+
+VirtualPort::VirtualPort(HostBoard &board, TxMode mode) : board_(board), mode_(mode) {}
+
+void VirtualPort::begin(unsigned long baud) {
+  baud_ = baud;
+}
+
+uint64_t VirtualPort::frameMicros() const {
+  // Start bit, 8 data bits, stop bit
+  return baud_ ? (10000000ULL + baud_ - 1) / baud_ : 0;
+}
+
+void VirtualPort::send(const std::string &bytes) {
+  send(reinterpret_cast<const uint8_t *>(bytes.data()), bytes.size());
+}
+
+void VirtualPort::send(const uint8_t *data, size_t length) {
+  uint64_t at = std::max(board_.micros(), lineFreeAt_);
+  for (size_t i = 0; i < length; i++) {
+    at += frameMicros();
+    pending_.push_back(Incoming{at, data[i]});
+  }
+  lineFreeAt_ = at;
+}
+
+std::string VirtualPort::takeOutput() {
+  std::string out;
+  out.swap(output_);
+  return out;
+}
+
+// Move bytes that have finished arriving into the receive buffer. Between
+// two calls the sketch has not read anything, so a byte that finds the
+// buffer full now would have found it full when it arrived.
+void VirtualPort::deliver() {
+  uint64_t now = board_.micros();
+  while (!pending_.empty() && pending_.front().arrivesAt <= now) {
+    if (received_.size() < kBufferSize) {
+      received_.push_back(pending_.front().byte);
+    } else {
+      dropped_++;
+    }
+    pending_.pop_front();
+  }
+}
+
+int VirtualPort::available() {
+  deliver();
+  return (int)received_.size();
+}
+
+int VirtualPort::read() {
+  deliver();
+  if (received_.empty()) {
+    return -1;
+  }
+  int c = received_.front();
+  received_.pop_front();
+  return c;
+}
+
+int VirtualPort::peek() {
+  deliver();
+  return received_.empty() ? -1 : received_.front();
+}
+
+size_t VirtualPort::write(uint8_t byte) {
+  uint64_t now = board_.micros();
+  if (mode_ == TxMode::Blocking) {
+    // Interrupts are off for the frame; an encoder edge in it waits, and a
+    // second edge on the same pin is lost, as on the robot
+    bool enabled = board_.interruptsEnabled();
+    board_.setInterruptsEnabled(false);
+    board_.advance(frameMicros());
+    board_.setInterruptsEnabled(enabled);
+  } else {
+    // Wait for room in the transmit buffer
+    uint64_t start = std::max(now, txDoneAt_);
+    uint64_t queued = start - now;
+    uint64_t bufferMicros = kBufferSize * frameMicros();
+    if (queued > bufferMicros) {
+      board_.advance(queued - bufferMicros);
+    }
+    txDoneAt_ = start + frameMicros();
+  }
+  output_.push_back((char)byte);
+  return 1;
+}
+
+int VirtualPort::availableForWrite() {
+  if (mode_ == TxMode::Blocking || frameMicros() == 0) {
+    return 0;
+  }
+  uint64_t now = board_.micros();
+  uint64_t queued = txDoneAt_ > now ? (txDoneAt_ - now + frameMicros() - 1) / frameMicros() : 0;
+  return queued >= kBufferSize ? 0 : (int)(kBufferSize - queued);
+}
+
+void VirtualPort::flush() {
+  if (txDoneAt_ > board_.micros()) {
+    board_.advance(txDoneAt_ - board_.micros());
+  }
+}
+
+HostBoard::HostBoard() : eeprom_(kEepromSize, 0xFF) {
+  reset();
+}
+
+void HostBoard::reset() {
+  clock_.reset();
+  for (int i = 0; i < kPins; i++) {
+    modes_[i] = 0;
+    outputs_[i] = 0;
+    inputs_[i] = 0;
+  }
+  for (int i = 0; i < kInterrupts; i++) {
+    handlers_[i] = nullptr;
+    pendingInterrupts_[i] = false;
+  }
+  interruptsEnabled_ = true;
+  serial_.reset(new VirtualPort(*this, VirtualPort::TxMode::Buffered));
+  softwareSerials_.clear();
+}
+
+void HostBoard::setPinMode(uint8_t pin, uint8_t mode) {
+  if (pin < kPins) {
+    modes_[pin] = mode;
+  }
+}
+
+uint8_t HostBoard::pinMode(uint8_t pin) const {
+  return pin < kPins ? modes_[pin] : 0;
+}
+
+void HostBoard::writePin(uint8_t pin, int value) {
+  if (pin < kPins) {
+    outputs_[pin] = value;
+  }
+}
+
+int HostBoard::pinOutput(uint8_t pin) const {
+  return pin < kPins ? outputs_[pin] : 0;
+}
+
+void HostBoard::setPinInput(uint8_t pin, int level) {
+  if (pin < kPins) {
+    inputs_[pin] = level;
+  }
+}
+
+int HostBoard::readPin(uint8_t pin) const {
+  return pin < kPins ? inputs_[pin] : 0;
+}
+
+int HostBoard::readAnalog(uint8_t pin) {
+  return analogSource_ ? analogSource_(pin) : 0;
+}
+
+void HostBoard::attachInterrupt(uint8_t number, InterruptHandler handler) {
+  if (number < kInterrupts) {
+    handlers_[number] = handler;
+  }
+}
+
+void HostBoard::detachInterrupt(uint8_t number) {
+  if (number < kInterrupts) {
+    handlers_[number] = nullptr;
+  }
+}
+
+void HostBoard::trigger(uint8_t number) {
+  if (number >= kInterrupts || !handlers_[number]) {
+    return;
+  }
+  if (!interruptsEnabled_) {
+    pendingInterrupts_[number] = true;
+    return;
+  }
+  handlers_[number]();
+}
+
+void HostBoard::setInterruptsEnabled(bool enabled) {
+  interruptsEnabled_ = enabled;
+  if (!enabled) {
+    return;
+  }
+  for (int i = 0; i < kInterrupts; i++) {
+    if (pendingInterrupts_[i]) {
+      pendingInterrupts_[i] = false;
+      trigger((uint8_t)i);
+    }
+  }
+}
+
+VirtualPort &HostBoard::softwareSerial(uint8_t rxPin) {
+  VirtualPort *port = findSoftwareSerial(rxPin);
+  if (port) {
+    return *port;
+  }
+  softwareSerials_.emplace_back(rxPin, std::unique_ptr<VirtualPort>(
+                                           new VirtualPort(*this, VirtualPort::TxMode::Blocking)));
+  return *softwareSerials_.back().second;
+}
+
+VirtualPort *HostBoard::findSoftwareSerial(uint8_t rxPin) {
+  for (auto &entry : softwareSerials_) {
+    if (entry.first == rxPin) {
+      return entry.second.get();
+    }
+  }
+  return nullptr;
+}
+
+void HostBoard::noteHeap(size_t oldSize, size_t newSize) {
+  if (newSize) {
+    heap_.allocations++;
+  } else if (oldSize) {
+    heap_.frees++;
+  }
+  heap_.liveBytes -= std::min(oldSize, heap_.liveBytes);
+  heap_.liveBytes += newSize;
+  heap_.peakBytes = std::max(heap_.peakBytes, heap_.liveBytes);
+}
+
+HostBoard &board() {
+  static HostBoard instance;
+  return instance;
+}
+
+}  // namespace sim
@@ -0,0 +1,161 @@
+// Smart Waiter Robot - Simulated Board
+// The Uno the sketch thinks it is running on: clock, pins, analog inputs,
+// interrupt vectors, EEPROM and serial ports. The host Arduino core
+// (sim/core) forwards every call here, and the simulator drives the other
+// side: it moves the clock on, supplies sensor readings, fires encoder
+// interrupts and talks to the serial ports like a phone or a PC would.
+// Each board keeps its own virtual clock (virtual_clock.h).
+
+#ifndef SIM_HOST_BOARD_H
+#define SIM_HOST_BOARD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "virtual_clock.h"
+
+namespace sim {
+
+class HostBoard;
+
+// One serial port, seen from both ends. Bytes from the host arrive one
+// frame time (10 bits at the baud rate) apart and land in a 64-byte receive
+// buffer like the AVR's, so a sketch that reads too slowly loses bytes.
+// Writes either hold the CPU for the whole frame (SoftwareSerial bit-bangs
+// with interrupts off) or queue in a 64-byte transmit buffer and only block
+// when it is full (HardwareSerial).
+class VirtualPort {
+public:
+  enum class TxMode { Blocking, Buffered };
+
+  static const size_t kBufferSize = 64;
+
+  VirtualPort(HostBoard &board, TxMode mode);
+
+  void begin(unsigned long baud);
+  unsigned long baud() const { return baud_; }
+  bool started() const { return baud_ != 0; }
+
+  // Host side
+  void send(const std::string &bytes);
+  void send(const uint8_t *data, size_t length);
+  std::string takeOutput();
+  const std::string &output() const { return output_; }
+  unsigned long droppedBytes() const { return dropped_; }
+
+  // Sketch side
+  int available();
+  int read();
+  int peek();
+  size_t write(uint8_t byte);
+  int availableForWrite();
+  void flush();
+
+private:
+  struct Incoming {
+    uint64_t arrivesAt;
+    uint8_t byte;
+  };
+
+  HostBoard &board_;
+  TxMode mode_;
+  unsigned long baud_ = 0;
+  std::deque<Incoming> pending_;   // Sent by the host, still on the wire
+  std::deque<uint8_t> received_;   // In the receive buffer
+  uint64_t lineFreeAt_ = 0;        // Host -> sketch wire busy until
+  uint64_t txDoneAt_ = 0;          // Sketch -> host wire busy until
+  std::string output_;
+  unsigned long dropped_ = 0;
+
+  uint64_t frameMicros() const;
+  void deliver();
+};
+
+// Heap use by String, the only thing in the sketch that allocates, counted
+// as the AVR core would allocate it (sim/core/WString.h)
+struct HeapStats {
+  unsigned long allocations = 0;  // Buffers obtained or grown
+  unsigned long frees = 0;
+  size_t liveBytes = 0;
+  size_t peakBytes = 0;
+};
+
+class HostBoard {
+public:
+  typedef void (*InterruptHandler)();
+  typedef std::function<int(uint8_t pin)> AnalogSource;
+
+  static const int kPins = 20;
+  static const int kInterrupts = 2;
+  static const size_t kEepromSize = 1024;
+
+  HostBoard();
+
+  // Power-on state: clock at zero, pins low, no interrupts attached, ports
+  // closed. EEPROM keeps its contents, as on the robot.
+  void reset();
+
+  // Clock. Advancing runs whatever is scheduled on it on the way.
+  VirtualClock &clock() { return clock_; }
+  uint64_t micros() const { return clock_.micros(); }
+  void advance(uint64_t us) { clock_.advance(us); }
+
+  // Pins. pinOutput() is the last digitalWrite level or analogWrite duty.
+  void setPinMode(uint8_t pin, uint8_t mode);
+  uint8_t pinMode(uint8_t pin) const;
+  void writePin(uint8_t pin, int value);
+  int pinOutput(uint8_t pin) const;
+  void setPinInput(uint8_t pin, int level);
+  int readPin(uint8_t pin) const;
+
+  // analogRead() asks the source; without one every input reads 0
+  void setAnalogSource(AnalogSource source) { analogSource_ = source; }
+  int readAnalog(uint8_t pin);
+
+  // External interrupts. A trigger while interrupts are off runs when they
+  // are turned back on.
+  void attachInterrupt(uint8_t number, InterruptHandler handler);
+  void detachInterrupt(uint8_t number);
+  void trigger(uint8_t number);
+  void setInterruptsEnabled(bool enabled);
+  bool interruptsEnabled() const { return interruptsEnabled_; }
+
+  // Serial is the USB port; a SoftwareSerial port is found by its RX pin
+  VirtualPort &serial() { return *serial_; }
+  VirtualPort &softwareSerial(uint8_t rxPin);
+  VirtualPort *findSoftwareSerial(uint8_t rxPin);
+
+  std::vector<uint8_t> &eeprom() { return eeprom_; }
+
+  // A heap block of oldSize bytes became newSize bytes; 0 is no block
+  void noteHeap(size_t oldSize, size_t newSize);
+  const HeapStats &heap() const { return heap_; }
+  void resetHeapPeak() { heap_.peakBytes = heap_.liveBytes; }
+
+private:
+  VirtualClock clock_;
+  uint8_t modes_[kPins];
+  int outputs_[kPins];
+  int inputs_[kPins];
+  AnalogSource analogSource_;
+  InterruptHandler handlers_[kInterrupts];
+  bool pendingInterrupts_[kInterrupts];
+  bool interruptsEnabled_ = true;
+  std::unique_ptr<VirtualPort> serial_;
+  std::vector<std::pair<uint8_t, std::unique_ptr<VirtualPort>>> softwareSerials_;
+  std::vector<uint8_t> eeprom_;
+  HeapStats heap_;
+};
+
+// The board the sketch in this process (or loaded module, see
+// firmware_instance.h) runs on
+HostBoard &board();
+
+}  // namespace sim
+
+#endif
@@ -0,0 +1,127 @@
+#!/usr/bin/env python3
+"""Smart Waiter Robot - sketch to C++ for the host build.
+
+Does what the Arduino builder does before compiling a sketch: includes
+Arduino.h first, and declares every function ahead of the first function
+definition so functions can be used before they are defined. #line
+directives keep compiler messages pointing at the .ino.
+
+usage: ino_to_cpp.py sketch.ino output.cpp
+"""
+
+import re
+import sys
+
+KEYWORDS = {"if", "for", "while", "switch", "return", "else", "do", "sizeof", "catch"}
+NOT_FUNCTIONS = ("class", "struct", "enum", "union", "namespace", "typedef", "template")
+
+
+def blank_comments_and_strings(source):
+    """Replace comments, string and character literals with spaces, keeping
+    newlines so offsets and line numbers still match the original."""
+    out = []
+    i = 0
+    n = len(source)
+    while i < n:
+        c = source[i]
+        if source.startswith("//", i):
+            end = source.find("\n", i)
+            end = n if end < 0 else end
+            out.append(" " * (end - i))
+            i = end
+        elif source.startswith("/*", i):
+            end = source.find("*/", i + 2)
+            end = n if end < 0 else end + 2
+            out.append(re.sub(r"[^\n]", " ", source[i:end]))
+            i = end
+        elif c in "\"'":
+            j = i + 1
+            while j < n and source[j] != c:
+                j += 2 if source[j] == "\\" else 1
+            j = min(j + 1, n)
+            out.append(c + " " * (j - i - 2) + c if j - i >= 2 else source[i:j])
+            i = j
+        else:
+            out.append(c)
+            i += 1
+    return "".join(out)
+
+
+def blank_preprocessor(source):
+    """Blank preprocessor lines (with their continuations)."""
+    lines = source.split("\n")
+    continued = False
+    for index, line in enumerate(lines):
+        if continued or line.lstrip().startswith("#"):
+            continued = line.rstrip().endswith("\\")
+            lines[index] = " " * len(line)
+    return "\n".join(lines)
+
+
+def find_functions(source):
+    """Yield (prototype, offset of the definition) for each top-level
+    function definition."""
+    text = blank_preprocessor(blank_comments_and_strings(source))
+    depth = 0
+    statement_start = 0
+    for i, c in enumerate(text):
+        if c == "{":
+            if depth == 0:
+                header = text[statement_start:i]
+                prototype = function_prototype(header)
+                if prototype:
+                    offset = statement_start + len(header) - len(header.lstrip())
+                    yield prototype, offset
+            depth += 1
+        elif c == "}":
+            depth -= 1
+            if depth == 0:
+                statement_start = i + 1
+        elif c == ";" and depth == 0:
+            statement_start = i + 1
+
+
+def function_prototype(header):
+    header = " ".join(header.split())
+    if not header or "=" in header.split("(")[0] or header.startswith(NOT_FUNCTIONS):
+        return None
+    match = re.match(r"^(.*?[\s\*&])\s*([A-Za-z_]\w*)\s*\((.*)\)\s*(const)?$", header)
+    if not match:
+        return None
+    return_type, name, params = match.group(1).strip(), match.group(2), match.group(3)
+    if not return_type or name in KEYWORDS or return_type in KEYWORDS or return_type.endswith("::"):
+        return None
+    # Default arguments belong on the first declaration only
+    params = re.sub(r"\s*=\s*[^,]+", "", params)
+    return "%s %s(%s);" % (return_type, name, params)
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+    path, output = sys.argv[1], sys.argv[2]
+    with open(path) as f:
+        source = f.read()
+
+    functions = list(find_functions(source))
+    prototypes = [prototype for prototype, _ in functions]
+    insert_at = functions[0][1] if functions else len(source)
+    # Start of the line holding the first definition
+    insert_at = source.rfind("\n", 0, insert_at) + 1
+    insert_line = source.count("\n", 0, insert_at) + 1
+
+    name = path.replace("\\", "/")
+    parts = [
+        "#include <Arduino.h>\n",
+        '#line 1 "%s"\n' % name,
+        source[:insert_at],
+        "\n".join(prototypes) + "\n",
+        '#line %d "%s"\n' % (insert_line, name),
+        source[insert_at:],
+    ]
+    with open(output, "w") as f:
+        f.write("".join(parts))
+
+
+if __name__ == "__main__":
+    main()
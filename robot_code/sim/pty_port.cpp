@@ -0,0 +1,84 @@
+// Smart Waiter Robot - Pseudo-terminal Port
+
+#include "pty_port.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace sim {
+
+PtyPort::~PtyPort() {
+  if (!link_.empty()) {
+    ::unlink(link_.c_str());
+  }
+  if (slave_ >= 0) {
+    ::close(slave_);
+  }
+  if (master_ >= 0) {
+    ::close(master_);
+  }
+}
+
+bool PtyPort::open(std::string &error) {
+  master_ = ::posix_openpt(O_RDWR | O_NOCTTY);
+  if (master_ < 0 || ::grantpt(master_) != 0 || ::unlockpt(master_) != 0) {
+    error = std::string("cannot create a pty: ") + std::strerror(errno);
+    return false;
+  }
+  const char *name = ::ptsname(master_);
+  if (!name) {
+    error = std::string("cannot name the pty: ") + std::strerror(errno);
+    return false;
+  }
+  path_ = name;
+
+  // Raw, so the sketch sees every byte as sent, at once and without echo.
+  // A program that opens the pty can still set its own modes.
+  slave_ = ::open(path_.c_str(), O_RDWR | O_NOCTTY);
+  termios modes;
+  if (slave_ < 0 || ::tcgetattr(slave_, &modes) != 0) {
+    error = "cannot open " + path_ + ": " + std::strerror(errno);
+    return false;
+  }
+  ::cfmakeraw(&modes);
+  ::tcsetattr(slave_, TCSANOW, &modes);
+  ::fcntl(master_, F_SETFL, ::fcntl(master_, F_GETFL) | O_NONBLOCK);
+  return true;
+}
+
+bool PtyPort::link(const std::string &linkPath, std::string &error) {
+  ::unlink(linkPath.c_str());
+  if (::symlink(path_.c_str(), linkPath.c_str()) != 0) {
+    error = "cannot link " + linkPath + ": " + std::strerror(errno);
+    return false;
+  }
+  link_ = linkPath;
+  return true;
+}
+
+void PtyPort::pump(VirtualPort &port) {
+  uint8_t incoming[256];
+  ssize_t count;
+  while ((count = ::read(master_, incoming, sizeof(incoming))) > 0) {
+    port.send(incoming, (size_t)count);
+  }
+
+  backlog_ += port.takeOutput();
+  while (!backlog_.empty()) {
+    count = ::write(master_, backlog_.data(), backlog_.size());
+    if (count <= 0) {
+      break;
+    }
+    backlog_.erase(0, (size_t)count);
+  }
+  if (backlog_.size() > kMaxBacklog) {
+    backlog_.erase(0, backlog_.size() - kMaxBacklog);
+  }
+}
+
+}  // namespace sim
@@ -0,0 +1,56 @@
+// Smart Waiter Robot - Pseudo-terminal Port
+// Connects a virtual serial port (host_board.h) to a Linux pseudo-terminal,
+// so a program that talks to the robot through a serial device - a
+// terminal such as picocom, a pyserial script, a gateway - can open the
+// pty (or a symlink to it) in place of /dev/rfcomm0 and talk to the
+// simulated robot instead. Bytes still go through the virtual port, so
+// they arrive at the port's baud rate and overflow a sketch that reads too
+// slowly, as on the robot.
+
+#ifndef SIM_PTY_PORT_H
+#define SIM_PTY_PORT_H
+
+#include <string>
+
+#include "host_board.h"
+
+namespace sim {
+
+class PtyPort {
+public:
+  // Replies nobody has read yet are kept up to this many bytes; older ones
+  // are dropped, as the HC-05 drops them with no phone connected
+  static const size_t kMaxBacklog = 4096;
+
+  PtyPort() = default;
+  PtyPort(const PtyPort &) = delete;
+  PtyPort &operator=(const PtyPort &) = delete;
+  ~PtyPort();
+
+  // Create the pty, in raw mode. False, with the reason in error, if the
+  // system has none to give.
+  bool open(std::string &error);
+  // Also make it reachable as linkPath (a symlink, removed again on
+  // destruction)
+  bool link(const std::string &linkPath, std::string &error);
+
+  // The device for the other program, e.g. /dev/pts/3
+  const std::string &path() const { return path_; }
+  // Readable when the other program has written something
+  int fd() const { return master_; }
+
+  // Pass what the other program wrote to the port, and what the sketch
+  // wrote to the other program. Never blocks.
+  void pump(VirtualPort &port);
+
+private:
+  int master_ = -1;
+  int slave_ = -1;  // Held open so the pty outlives the other program closing it
+  std::string path_;
+  std::string link_;
+  std::string backlog_;  // Written by the sketch, not yet taken by the pty
+};
+
+}  // namespace sim
+
+#endif
@@ -0,0 +1,109 @@
+// Smart Waiter Robot - Simulated Robot
+
+#include "robot_model.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace sim {
+
+RobotModel::RobotModel(const TrackMap &track, const RobotParameters &parameters,
+                       const RobotWiring &wiring)
+    : track_(track), parameters_(parameters), wiring_(wiring) {
+  reset();
+}
+
+void RobotModel::reset() {
+  const Pose &start = track_.start();
+  pose_ = Pose{start.x - parameters_.sensorAheadMm * std::cos(start.heading),
+               start.y - parameters_.sensorAheadMm * std::sin(start.heading), start.heading};
+  leftSpeed_ = rightSpeed_ = 0;
+  leftTickMm_ = rightTickMm_ = 0;
+  travelled_ = 0;
+  noiseState_ = parameters_.noiseSeed;
+}
+
+void RobotModel::connect(HostBoard &board) {
+  uint8_t first = wiring_.firstSensorPin;
+  board.setAnalogSource([this, first](uint8_t pin) {
+    int sensor = pin - first;
+    return sensor >= 0 && sensor < kRobotSensors ? sensorReading(sensor) : 0;
+  });
+}
+
+int RobotModel::leftPwm(const HostBoard &board) const {
+  return board.pinOutput(wiring_.leftForwardPin) - board.pinOutput(wiring_.leftReversePin);
+}
+
+int RobotModel::rightPwm(const HostBoard &board) const {
+  return board.pinOutput(wiring_.rightForwardPin) - board.pinOutput(wiring_.rightReversePin);
+}
+
+double RobotModel::wheelSpeedFor(int pwm) const {
+  int magnitude = std::abs(pwm);
+  if (magnitude <= parameters_.motorStartPwm) {
+    return 0;
+  }
+  double speed = (double)(magnitude - parameters_.motorStartPwm) * parameters_.fullSpeedMmS /
+                 (255 - parameters_.motorStartPwm);
+  return pwm < 0 ? -speed : speed;
+}
+
+void RobotModel::step(HostBoard &board, double dt) {
+  // Wheel speeds lag behind the PWM
+  if (dt != blendDt_) {
+    blendDt_ = dt;
+    blend_ = 1 - std::exp(-dt * 1000 / parameters_.motorLagMs);
+  }
+  double blend = blend_;
+  leftSpeed_ += (wheelSpeedFor(leftPwm(board)) - leftSpeed_) * blend;
+  rightSpeed_ += (wheelSpeedFor(rightPwm(board)) - rightSpeed_) * blend;
+
+  double left = leftSpeed_ * dt;
+  double right = rightSpeed_ * dt;
+  double forward = (left + right) / 2;
+  double turn = (right - left) / parameters_.wheelBaseMm;
+  double midHeading = pose_.heading + turn / 2;
+  pose_.x += forward * std::cos(midHeading);
+  pose_.y += forward * std::sin(midHeading);
+  pose_.heading += turn;
+  travelled_ += std::fabs(forward);
+
+  // One interrupt per slot edge; the encoders cannot tell direction
+  leftTickMm_ += std::fabs(left);
+  while (leftTickMm_ >= parameters_.mmPerEncoderTick) {
+    leftTickMm_ -= parameters_.mmPerEncoderTick;
+    board.trigger(wiring_.leftEncoderInterrupt);
+  }
+  rightTickMm_ += std::fabs(right);
+  while (rightTickMm_ >= parameters_.mmPerEncoderTick) {
+    rightTickMm_ -= parameters_.mmPerEncoderTick;
+    board.trigger(wiring_.rightEncoderInterrupt);
+  }
+}
+
+// Sensor 0 is on the left, 2 on the right
+Point RobotModel::sensorPosition(int sensor) const {
+  double side = (1 - sensor) * parameters_.sensorSpacingMm;
+  double c = std::cos(pose_.heading);
+  double s = std::sin(pose_.heading);
+  return Point{pose_.x + parameters_.sensorAheadMm * c - side * s,
+               pose_.y + parameters_.sensorAheadMm * s + side * c};
+}
+
+int RobotModel::sensorReading(int sensor) const {
+  // Share of the sensor's spot that is over tape
+  double d = track_.distanceToTape(sensorPosition(sensor));
+  double halfTape = track_.tapeWidthMm() / 2;
+  double spot = parameters_.sensorSpotMm;
+  double covered = std::max(0.0, std::min(1.0, (halfTape + spot - d) / (2 * spot)));
+  double reading = parameters_.floorReading +
+                   (parameters_.lineReading - parameters_.floorReading) * covered;
+  if (parameters_.sensorNoise > 0) {
+    noiseState_ = noiseState_ * 1103515245u + 12345u;
+    reading += (int)((noiseState_ >> 16) % (2 * parameters_.sensorNoise + 1)) - parameters_.sensorNoise;
+  }
+  return std::max(0, std::min(1023, (int)std::lround(reading)));
+}
+
+}  // namespace sim
@@ -0,0 +1,92 @@
+// Smart Waiter Robot - Simulated Robot
+// Two-wheel differential drive on the simulated track. Each step reads the
+// L298N inputs the sketch wrote, moves the wheels towards the speed that
+// PWM gives (first-order lag, so the robot takes time to speed up and slow
+// down), moves the robot and fires an encoder interrupt for every slot
+// edge each wheel passes. The line sensors read how much of their spot is
+// over tape, between the floor and line readings.
+
+#ifndef SIM_ROBOT_MODEL_H
+#define SIM_ROBOT_MODEL_H
+
+#include <cstdint>
+
+#include "host_board.h"
+#include "track_map.h"
+
+namespace sim {
+
+// Where the sketch expects everything (smart_waiter_robot.ino)
+struct RobotWiring {
+  uint8_t leftForwardPin = 5;
+  uint8_t leftReversePin = 6;
+  uint8_t rightForwardPin = 9;
+  uint8_t rightReversePin = 10;
+  uint8_t leftEncoderInterrupt = 0;   // D2
+  uint8_t rightEncoderInterrupt = 1;  // D3
+  uint8_t firstSensorPin = 14;        // A0 left, A1 center, A2 right
+};
+
+struct RobotParameters {
+  double wheelBaseMm = 140;
+  double sensorAheadMm = 70;     // Sensor bar ahead of the axle
+  double sensorSpacingMm = 18;
+  double sensorSpotMm = 5;       // Radius each sensor sees
+  double mmPerEncoderTick = 5.105;
+  int motorStartPwm = 50;        // PWM at which the wheels start turning
+  double fullSpeedMmS = 700;     // Speed at PWM 255
+  double motorLagMs = 60;        // Time constant of the wheel speed
+  int floorReading = 850;        // Raw ADC over bare floor
+  int lineReading = 150;         // Raw ADC over the middle of the tape
+  int sensorNoise = 0;           // Up to +/- this many counts, repeatable
+  uint32_t noiseSeed = 1;        // Same seed, same noise
+};
+
+const int kRobotSensors = 3;
+
+class RobotModel {
+public:
+  RobotModel(const TrackMap &track, const RobotParameters &parameters = RobotParameters(),
+             const RobotWiring &wiring = RobotWiring());
+
+  // Stand still with the sensor bar at the track's start
+  void reset();
+
+  // Serve analogRead() for the sensor pins of this board
+  void connect(HostBoard &board);
+
+  // Advance by dt seconds with the motor inputs on the board's pins
+  void step(HostBoard &board, double dt);
+
+  const Pose &pose() const { return pose_; }          // Axle center
+  Point sensorPosition(int sensor) const;
+  int sensorReading(int sensor) const;
+  double leftSpeedMmS() const { return leftSpeed_; }
+  double rightSpeedMmS() const { return rightSpeed_; }
+  double speedMmS() const { return (leftSpeed_ + rightSpeed_) / 2; }
+  double travelledMm() const { return travelled_; }  // Along the path, either way
+  int leftPwm(const HostBoard &board) const;           // Negative = reverse
+  int rightPwm(const HostBoard &board) const;
+
+  const RobotParameters &parameters() const { return parameters_; }
+
+private:
+  const TrackMap &track_;
+  RobotParameters parameters_;
+  RobotWiring wiring_;
+  Pose pose_;
+  double leftSpeed_ = 0;
+  double rightSpeed_ = 0;
+  double leftTickMm_ = 0;
+  double rightTickMm_ = 0;
+  double travelled_ = 0;
+  mutable uint32_t noiseState_ = 1;
+  double blendDt_ = 0;  // Speed lag for the last step length
+  double blend_ = 0;
+
+  double wheelSpeedFor(int pwm) const;
+};
+
+}  // namespace sim
+
+#endif
@@ -0,0 +1,175 @@
+// Smart Waiter Robot - Simulation Scripts
+
+#include "script_runner.h"
+
+#include <cstdio>
+#include <sstream>
+
+#include "../track_layout.h"
+
+namespace sim {
+
+void ScriptRunner::ReplyLog::collect(VirtualPort &port, uint64_t micros) {
+  if (port.output().empty()) {
+    return;
+  }
+  std::string bytes = port.takeOutput();
+  for (char c : bytes) {
+    if (c == '\n') {
+      print(micros);
+    } else if (c != '\r') {
+      partial_ += c;
+    }
+  }
+}
+
+void ScriptRunner::ReplyLog::mark() {
+  recent_.clear();
+  watched_.clear();
+  seen_ = false;
+}
+
+void ScriptRunner::ReplyLog::watch(const std::string &text) {
+  watched_ = text;
+  seen_ = false;
+  for (const std::string &line : recent_) {
+    seen_ = seen_ || line.find(text) != std::string::npos;
+  }
+}
+
+void ScriptRunner::ReplyLog::print(uint64_t micros) {
+  std::string shown;
+  for (unsigned char c : partial_) {
+    if (c >= 0x20 && c < 0x7F) {
+      shown += (char)c;
+    } else {
+      char hex[8];
+      std::snprintf(hex, sizeof(hex), "\\x%02X", c);
+      shown += hex;
+    }
+  }
+  char time[24];
+  std::snprintf(time, sizeof(time), "%9.3f", micros / 1e6);
+  log_ << time << ' ' << prefix_ << ' ' << shown << '\n';
+  if (!watched_.empty() && partial_.find(watched_) != std::string::npos) {
+    seen_ = true;
+  }
+  recent_.push_back(partial_);
+  partial_.clear();
+}
+
+ScriptRunner::ScriptRunner(Simulation &simulation, std::ostream &log)
+    : simulation_(simulation), log_(log), replies_(log, "<"), serialLog_(log, "serial") {}
+
+void ScriptRunner::observe() {
+  replies_.collect(simulation_.bluetooth(), simulation_.micros());
+  if (showSerial_) {
+    serialLog_.collect(simulation_.serial(), simulation_.micros());
+  } else if (!simulation_.serial().output().empty()) {
+    simulation_.serial().takeOutput();
+  }
+  if (observer_) {
+    observer_();
+  }
+}
+
+void ScriptRunner::print(const char *marker, const std::string &text) {
+  char time[24];
+  std::snprintf(time, sizeof(time), "%9.3f", simulation_.micros() / 1e6);
+  log_ << time << ' ' << marker << ' ' << text << '\n';
+}
+
+unsigned long ScriptRunner::heapAllocations() const {
+  return simulation_.board().heap().allocations - setupAllocations_;
+}
+
+bool ScriptRunner::run(std::istream &script) {
+  simulation_.setObserver([this]() { observe(); });
+  simulation_.start();
+  setupAllocations_ = simulation_.board().heap().allocations;
+  observe();
+
+  bool passed = true;
+  std::string line;
+  while (std::getline(script, line)) {
+    std::istringstream words(line);
+    std::string directive;
+    if (!(words >> directive) || directive[0] == '#') {
+      continue;
+    }
+    if (directive == "wait") {
+      double ms = 0;
+      words >> ms;
+      simulation_.runFor((uint64_t)(ms * 1000));
+    } else if (directive == "until") {
+      std::string text;
+      double ms = 60000;
+      words >> text >> ms;
+      replies_.watch(text);
+      if (!simulation_.runUntil([this]() { return replies_.seen(); }, (uint64_t)(ms * 1000))) {
+        char within[24];
+        std::snprintf(within, sizeof(within), "%.0f", ms);
+        print("!", "no reply with \"" + text + "\" within " + within + " ms");
+        passed = false;
+      }
+      replies_.mark();
+    } else if (directive == "serial") {
+      std::string rest = line.substr(line.find("serial") + 6);
+      rest.erase(0, rest.find_first_not_of(' '));
+      print("serial>", rest);
+      simulation_.serial().send(rest + "\n");
+    } else {
+      std::string command = line.substr(line.find_first_not_of(" \t"));
+      print(">", command);
+      replies_.mark();
+      simulation_.bluetooth().send(command + "\n");
+    }
+  }
+  observe();
+
+  // The firmware keeps every string in fixed buffers once it is running
+  if (heapAllocations() > 0) {
+    print("!", std::to_string(heapAllocations()) + " heap allocations after setup()");
+    passed = false;
+  }
+  return passed;
+}
+
+bool layoutTrack(TrackMap &map, std::string &error) {
+  const unsigned int edgeCount = sizeof(layoutEdges) / sizeof(layoutEdges[0]);
+  std::vector<double> markers;
+  double lengthMm = 0;
+  unsigned char node = kHomeNode;
+  for (unsigned int visited = 0; visited < kLayoutNodes; visited++) {
+    const TrackEdge *next = nullptr;
+    for (unsigned int i = 0; i < edgeCount; i++) {
+      if (layoutEdges[i].from == node) {
+        if (next) {
+          next = nullptr;
+          break;
+        }
+        next = &layoutEdges[i];
+      }
+    }
+    if (!next) {
+      error = "the layout is not a single loop; pass a map with --map";
+      return false;
+    }
+    lengthMm += next->lengthMm;
+    node = next->to;
+    if (node != kHomeNode && (kLayoutMarkedNodes & (1UL << node))) {
+      markers.push_back(lengthMm);
+    }
+    if (node == kHomeNode) {
+      break;
+    }
+  }
+  if (node != kHomeNode || markers.size() + 1 != kLayoutNodes) {
+    error = "the layout is not a single loop; pass a map with --map";
+    return false;
+  }
+  map = loopTrack(lengthMm, markers);
+  return true;
+}
+
+}  // namespace sim
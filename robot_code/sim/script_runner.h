@@ -0,0 +1,85 @@
+// Smart Waiter Robot - Simulation Scripts
+// Plays a script of commands at a simulation and logs every reply with its
+// simulated time.
+//
+// Script lines:
+//   wait MS              run for MS milliseconds
+//   until WORD [MS]      run until a reply contains WORD (default 60000 ms);
+//                        the run fails if it does not come
+//   serial LINE          send LINE on the USB serial port
+//   # comment
+//   anything else        sent over Bluetooth as a command line
+
+#ifndef SIM_SCRIPT_RUNNER_H
+#define SIM_SCRIPT_RUNNER_H
+
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "simulation.h"
+#include "track_map.h"
+
+namespace sim {
+
+class ScriptRunner {
+public:
+  ScriptRunner(Simulation &simulation, std::ostream &log);
+
+  // Log the USB serial output as well
+  void setShowSerial(bool show) { showSerial_ = show; }
+  // Also called after every pass, e.g. to trace the path
+  void setObserver(const std::function<void()> &observer) { observer_ = observer; }
+
+  // Power the robot on and play the script. Returns false if an `until`
+  // timed out or the firmware used the heap after setup().
+  bool run(std::istream &script);
+
+  // Heap blocks the firmware obtained after setup() returned
+  unsigned long heapAllocations() const;
+
+private:
+  // Bytes sent by the robot, logged line by line with the time they
+  // completed. Lines since the last mark are searched for the watched
+  // text once, as they arrive, not on every pass.
+  class ReplyLog {
+  public:
+    ReplyLog(std::ostream &log, const char *prefix) : log_(log), prefix_(prefix) {}
+    void collect(VirtualPort &port, uint64_t micros);
+    void mark();
+    void watch(const std::string &text);
+    bool seen() const { return seen_; }
+
+  private:
+    std::ostream &log_;
+    std::string prefix_;
+    std::string partial_;
+    std::vector<std::string> recent_;
+    std::string watched_;
+    bool seen_ = false;
+
+    void print(uint64_t micros);
+  };
+
+  Simulation &simulation_;
+  std::ostream &log_;
+  ReplyLog replies_;
+  ReplyLog serialLog_;
+  bool showSerial_ = false;
+  std::function<void()> observer_;
+  unsigned long setupAllocations_ = 0;
+
+  void observe();
+  void print(const char *marker, const std::string &text);
+};
+
+// The compiled-in layout (track_layout.h) as a track, if it is a single
+// loop: every node has exactly one segment out of it and following them
+// from home visits each node once
+bool layoutTrack(TrackMap &map, std::string &error);
+
+}  // namespace sim
+
+#endif
@@ -0,0 +1,55 @@
+// Smart Waiter Robot - Simulation
+
+#include "simulation.h"
+
+// The sketch
+void setup(void);
+void loop(void);
+
+namespace sim {
+
+Simulation::Simulation(const TrackMap &track, const RobotParameters &parameters)
+    : board_(sim::board()), robot_(track, parameters) {}
+
+void Simulation::start() {
+  board_.reset();
+  bluetooth_ = nullptr;
+  robot_.reset();
+  robot_.connect(board_);
+  // The robot moves with the clock, whoever moves it
+  board_.clock().every(physicsMicros_,
+                       [this]() { robot_.step(board_, physicsMicros_ * 1e-6); }, physicsMicros_);
+  setup();
+  bluetooth_ = &board_.softwareSerial(kBluetoothRxPin);
+}
+
+void Simulation::step() {
+  uint64_t before = board_.micros();
+  loop();
+  if (board_.micros() == before) {
+    board_.advance(stepMicros_);
+  }
+  if (observer_) {
+    observer_();
+  }
+}
+
+void Simulation::runFor(uint64_t micros) {
+  uint64_t end = board_.micros() + micros;
+  while (board_.micros() < end) {
+    step();
+  }
+}
+
+bool Simulation::runUntil(const std::function<bool()> &done, uint64_t timeoutMicros) {
+  uint64_t end = board_.micros() + timeoutMicros;
+  while (!done()) {
+    if (board_.micros() >= end) {
+      return false;
+    }
+    step();
+  }
+  return true;
+}
+
+}  // namespace sim
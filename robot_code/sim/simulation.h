@@ -0,0 +1,74 @@
+// Smart Waiter Robot - Simulation
+// Runs the sketch (linked into the same program) on the simulated board
+// with the robot model on a track: loop() is called over and over and the
+// clock moves on by a fixed step per pass, or by however long the pass held
+// the CPU (a delay(), writing to SoftwareSerial). The physics is a periodic
+// event on the board's clock, so it keeps up whoever moves the clock and
+// encoder interrupts land in the middle of a long pass.
+
+#ifndef SIM_SIMULATION_H
+#define SIM_SIMULATION_H
+
+#include <cstdint>
+#include <functional>
+
+#include "host_board.h"
+#include "robot_model.h"
+#include "track_map.h"
+
+namespace sim {
+
+class Simulation {
+public:
+  static const uint64_t kDefaultStepMicros = 50;
+  // The robot moves well under a millimetre per physics step at full speed
+  static const uint64_t kDefaultPhysicsMicros = 250;
+
+  explicit Simulation(const TrackMap &track, const RobotParameters &parameters = RobotParameters());
+
+  // Power on: fresh board, robot at the start of the track, setup()
+  void start();
+
+  // One pass of loop()
+  void step();
+  void runFor(uint64_t micros);
+  // Run until done() is true, checked after every pass. Returns false if
+  // the timeout passed first.
+  bool runUntil(const std::function<bool()> &done, uint64_t timeoutMicros);
+
+  // Called after every pass, e.g. to collect replies or log the path
+  void setObserver(const std::function<void()> &observer) { observer_ = observer; }
+
+  // Do something at a simulated time, e.g. send a command mid-journey.
+  // Runs between two slices of physics, possibly in the middle of a pass.
+  void at(uint64_t micros, const std::function<void()> &action) {
+    board_.clock().at(micros, action);
+  }
+
+  void setStepMicros(uint64_t micros) { stepMicros_ = micros ? micros : 1; }
+  // Before start()
+  void setPhysicsMicros(uint64_t micros) { physicsMicros_ = micros ? micros : 1; }
+  uint64_t micros() const { return board_.micros(); }
+
+  HostBoard &board() { return board_; }
+  RobotModel &robot() { return robot_; }
+  // The HC-05 on the sketch's SoftwareSerial RX pin
+  VirtualPort &bluetooth() {
+    return bluetooth_ ? *bluetooth_ : board_.softwareSerial(kBluetoothRxPin);
+  }
+  VirtualPort &serial() { return board_.serial(); }
+
+private:
+  static const uint8_t kBluetoothRxPin = 11;
+
+  HostBoard &board_;
+  RobotModel robot_;
+  uint64_t stepMicros_ = kDefaultStepMicros;
+  uint64_t physicsMicros_ = kDefaultPhysicsMicros;
+  VirtualPort *bluetooth_ = nullptr;
+  std::function<void()> observer_;
+};
+
+}  // namespace sim
+
+#endif
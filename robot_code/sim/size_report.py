@@ -0,0 +1,123 @@
+#!/usr/bin/env python3
+"""Smart Waiter Robot - firmware size per variant.
+
+Reads the link maps of the firmware_size_<variant> host builds and sums
+what the sketch object (with every firmware header it inlines) kept after
+unused sections were dropped:
+
+  code    .text                 flash
+  const   .rodata               flash and RAM: the AVR copies constants,
+                                string literals included, into RAM
+  progmem .progmem.data         flash: PROGMEM tables and F()/PSTR strings
+                                (the host core keeps the AVR section name)
+  data    .data, .data.rel.ro   flash and RAM
+  bss     .bss                  RAM
+
+Host code is x86-64, so the byte counts are not AVR counts (pointers are
+8 bytes, and the compiler keeps some constants, such as switch tables, in
+.rodata that avr-gcc keeps in flash); compare the variants with each other. With --avr SKETCH_DIR each variant is also
+compiled for the Uno with arduino-cli and its reported flash and RAM use
+added to the table.
+
+usage: size_report.py [--avr SKETCH_DIR] VARIANT=MAP...
+"""
+
+import re
+import subprocess
+import sys
+
+SKETCH_OBJECT = "smart_waiter_robot.ino.cpp.o"
+KINDS = ("code", "const", "progmem", "data", "bss")
+
+
+def kind_of(section):
+    if section.startswith(".text"):
+        return "code"
+    if section.startswith(".rodata"):
+        return "const"
+    if section.startswith(".progmem"):
+        return "progmem"
+    if section.startswith(".data"):
+        return "data"
+    if section.startswith(".bss") or section == "COMMON":
+        return "bss"
+    return None
+
+
+def map_sizes(path):
+    """Bytes per kind contributed by the sketch object to the output."""
+    sizes = dict.fromkeys(KINDS, 0)
+    entry = re.compile(r"^ (\S+)?\s+0x[0-9a-f]+\s+0x([0-9a-f]+)\s+(\S+)$")
+    in_memory_map = False
+    section = None
+    with open(path) as lines:
+        for line in lines:
+            line = line.rstrip("\n")
+            if not in_memory_map:
+                in_memory_map = line.startswith("Linker script and memory map")
+                continue
+            # Long section names are printed alone, with the address, size
+            # and file on the next line
+            name_only = re.match(r"^ (\S+)$", line)
+            if name_only:
+                section = name_only.group(1)
+                continue
+            match = entry.match(line)
+            if match:
+                name = match.group(1) or section
+                if match.group(3).endswith(SKETCH_OBJECT):
+                    kind = kind_of(name or "")
+                    if kind:
+                        sizes[kind] += int(match.group(2), 16)
+            section = None
+    return sizes
+
+
+def avr_sizes(sketch_dir, variant):
+    """Flash and RAM bytes from arduino-cli, or None if it failed."""
+    command = ["arduino-cli", "compile", "--fqbn", "arduino:avr:uno",
+               "--build-property",
+               "compiler.cpp.extra_flags=-DWAITER_VARIANT=" + variant, sketch_dir]
+    try:
+        output = subprocess.run(command, stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                                universal_newlines=True).stdout
+    except OSError as error:
+        print("arduino-cli: %s" % error, file=sys.stderr)
+        return None
+    flash = re.search(r"Sketch uses (\d+) bytes", output)
+    ram = re.search(r"Global variables use (\d+) bytes", output)
+    if not flash or not ram:
+        print("arduino-cli failed for %s:\n%s" % (variant, output), file=sys.stderr)
+        return None
+    return int(flash.group(1)), int(ram.group(1))
+
+
+def main(argv):
+    sketch_dir = None
+    if len(argv) >= 2 and argv[0] == "--avr":
+        sketch_dir = argv[1]
+        argv = argv[2:]
+    if not argv or any("=" not in arg for arg in argv):
+        print(__doc__.strip().splitlines()[-1], file=sys.stderr)
+        return 2
+
+    header = "%-16s %8s %8s %8s %8s %8s %8s %8s" % (("variant",) + KINDS + ("flash", "ram"))
+    if sketch_dir:
+        header += " %9s %8s" % ("avr_flash", "avr_ram")
+    print(header)
+    for arg in argv:
+        variant, path = arg.split("=", 1)
+        sizes = map_sizes(path)
+        flash = sizes["code"] + sizes["const"] + sizes["progmem"] + sizes["data"]
+        ram = sizes["const"] + sizes["data"] + sizes["bss"]
+        row = "%-16s %8d %8d %8d %8d %8d %8d %8d" % (
+            (variant,) + tuple(sizes[kind] for kind in KINDS) + (flash, ram))
+        if sketch_dir:
+            avr = avr_sizes(sketch_dir, variant)
+            row += " %9s %8s" % avr if avr else " %9s %8s" % ("-", "-")
+        print(row)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
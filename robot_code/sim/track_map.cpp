@@ -0,0 +1,213 @@
+// Smart Waiter Robot - Simulated Track
+
+#include "track_map.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+namespace sim {
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+
+double radians(double degrees) {
+  return degrees * kPi / 180.0;
+}
+
+double distance(Point a, Point b) {
+  return std::hypot(a.x - b.x, a.y - b.y);
+}
+
+double distanceToSegment(Point p, Point a, Point b) {
+  double dx = b.x - a.x;
+  double dy = b.y - a.y;
+  double lengthSq = dx * dx + dy * dy;
+  double t = lengthSq > 0 ? ((p.x - a.x) * dx + (p.y - a.y) * dy) / lengthSq : 0;
+  t = std::max(0.0, std::min(1.0, t));
+  return distance(p, Point{a.x + t * dx, a.y + t * dy});
+}
+
+// One stretch of a path built from lengths: straight, or a left turn of
+// the given radius
+struct Span {
+  double lengthMm;
+  double turnRadiusMm;
+};
+
+Point turnCenter(Pose pose, double radiusMm) {
+  return Point{pose.x - radiusMm * std::sin(pose.heading), pose.y + radiusMm * std::cos(pose.heading)};
+}
+
+// Pose after the first runMm of a span starting at pose
+Pose follow(Pose pose, const Span &span, double runMm) {
+  if (span.turnRadiusMm <= 0) {
+    return Pose{pose.x + runMm * std::cos(pose.heading), pose.y + runMm * std::sin(pose.heading),
+                pose.heading};
+  }
+  Point center = turnCenter(pose, span.turnRadiusMm);
+  double heading = pose.heading + runMm / span.turnRadiusMm;
+  return Pose{center.x + span.turnRadiusMm * std::sin(heading),
+              center.y - span.turnRadiusMm * std::cos(heading), heading};
+}
+
+}  // namespace
+
+void TrackMap::addLine(Point from, Point to) {
+  pieces_.push_back(Piece{false, from, to, to, 0, 0, 0});
+}
+
+void TrackMap::addArc(Point center, double radiusMm, double startDeg, double sweepDeg) {
+  double start = radians(startDeg);
+  double end = radians(startDeg + sweepDeg);
+  pieces_.push_back(Piece{true, center,
+                          Point{center.x + radiusMm * std::cos(start),
+                                center.y + radiusMm * std::sin(start)},
+                          Point{center.x + radiusMm * std::cos(end), center.y + radiusMm * std::sin(end)},
+                          radiusMm, start, radians(sweepDeg)});
+}
+
+void TrackMap::addMarker(Pose at, double lengthMm) {
+  double half = lengthMm / 2;
+  double across = at.heading + kPi / 2;
+  addLine(Point{at.x - half * std::cos(across), at.y - half * std::sin(across)},
+          Point{at.x + half * std::cos(across), at.y + half * std::sin(across)});
+}
+
+double TrackMap::distanceToTape(Point p) const {
+  double best = 1e12;
+  for (const Piece &piece : pieces_) {
+    double d;
+    if (!piece.arc) {
+      d = distanceToSegment(p, piece.a, piece.b);
+    } else {
+      // Never nearer than the full circle; most arcs stop here
+      double fromCenter = distance(p, piece.a);
+      if (std::fabs(fromCenter - piece.radius) >= best) {
+        continue;
+      }
+      // Angle of p around the center, measured from the start of the sweep
+      double angle = std::atan2(p.y - piece.a.y, p.x - piece.a.x);
+      double from = piece.sweep >= 0 ? piece.start : piece.start + piece.sweep;
+      double offset = std::fmod(angle - from, 2 * kPi);
+      if (offset < 0) {
+        offset += 2 * kPi;
+      }
+      if (offset <= std::fabs(piece.sweep)) {
+        d = std::fabs(fromCenter - piece.radius);
+      } else {
+        d = std::min(distance(p, piece.b), distance(p, piece.c));
+      }
+    }
+    best = std::min(best, d);
+  }
+  return best;
+}
+
+bool TrackMap::load(std::istream &in, std::string &error) {
+  TrackMap map;
+  std::string line;
+  int number = 0;
+  while (std::getline(in, line)) {
+    number++;
+    line = line.substr(0, line.find('#'));
+    std::istringstream words(line);
+    std::string kind;
+    if (!(words >> kind)) {
+      continue;
+    }
+    double v[5] = {0, 0, 0, 0, 0};
+    int wanted = kind == "line" || kind == "arc" ? (kind == "arc" ? 5 : 4)
+               : kind == "marker" || kind == "start" ? 3
+               : kind == "tape" ? 1 : -1;
+    if (wanted < 0) {
+      error = "line " + std::to_string(number) + ": unknown element '" + kind + "'";
+      return false;
+    }
+    for (int i = 0; i < wanted; i++) {
+      if (!(words >> v[i])) {
+        error = "line " + std::to_string(number) + ": " + kind + " needs " +
+                std::to_string(wanted) + " numbers";
+        return false;
+      }
+    }
+    if (kind == "line") {
+      map.addLine(Point{v[0], v[1]}, Point{v[2], v[3]});
+    } else if (kind == "arc") {
+      map.addArc(Point{v[0], v[1]}, v[2], v[3], v[4]);
+    } else if (kind == "marker") {
+      double length = kMarkerLengthMm;
+      words >> length;
+      map.addMarker(Pose{v[0], v[1], radians(v[2])}, length);
+    } else if (kind == "start") {
+      map.setStart(Pose{v[0], v[1], radians(v[2])});
+    } else {
+      map.setTapeWidthMm(v[0]);
+    }
+  }
+  if (map.empty()) {
+    error = "no tape in map";
+    return false;
+  }
+  *this = map;
+  return true;
+}
+
+bool TrackMap::loadFile(const std::string &path, std::string &error) {
+  std::ifstream in(path);
+  if (!in) {
+    error = "cannot open " + path;
+    return false;
+  }
+  if (!load(in, error)) {
+    error = path + ": " + error;
+    return false;
+  }
+  return true;
+}
+
+TrackMap loopTrack(double lengthMm, const std::vector<double> &markersAtMm) {
+  // Four quarter turns; what is left over goes to the sides, 3:2
+  const double radius = 250;
+  double sides = std::max(0.0, lengthMm - 2 * kPi * radius);
+  double longSide = sides * 0.3;
+  double shortSide = sides * 0.2;
+  const double corner = radius * kPi / 2;
+  const Span spans[] = {
+    {longSide / 2, 0}, {corner, radius}, {shortSide, 0}, {corner, radius},
+    {longSide, 0},     {corner, radius}, {shortSide, 0}, {corner, radius},
+    {longSide / 2, 0}
+  };
+
+  TrackMap map;
+  Pose pose = {0, 0, 0};
+  for (const Span &span : spans) {
+    Pose end = follow(pose, span, span.lengthMm);
+    if (span.turnRadiusMm > 0) {
+      map.addArc(turnCenter(pose, radius), radius, pose.heading * 180.0 / kPi - 90, 90);
+    } else {
+      map.addLine(Point{pose.x, pose.y}, Point{end.x, end.y});
+    }
+    pose = end;
+  }
+  map.setStart(Pose{0, 0, 0});
+
+  for (double at : markersAtMm) {
+    Pose marker = {0, 0, 0};
+    double left = std::fmod(at, lengthMm);
+    for (const Span &span : spans) {
+      double run = std::min(left, span.lengthMm);
+      marker = follow(marker, span, run);
+      left -= run;
+      if (left <= 0) {
+        break;
+      }
+    }
+    map.addMarker(marker);
+  }
+  return map;
+}
+
+}  // namespace sim
@@ -0,0 +1,86 @@
+// Smart Waiter Robot - Simulated Track
+// The tape on the restaurant floor: line segments and arcs along the middle
+// of the tape, plus short cross lines for the table markers. The robot
+// model asks how far each line sensor is from the nearest tape to work out
+// what the sensor reads.
+//
+// Maps can be written by hand, one element per line (mm and degrees,
+// angles counter-clockwise from +x, '#' starts a comment):
+//   line   x0 y0 x1 y1
+//   arc    cx cy radius start sweep    (sweep < 0 runs clockwise)
+//   marker x y heading [length]        (cross line at x,y across a line
+//                                       running at heading)
+//   start  x y heading                 (where the sensor bar starts: home)
+//   tape   width
+// or built from a single-loop layout with loopTrack().
+
+#ifndef SIM_TRACK_MAP_H
+#define SIM_TRACK_MAP_H
+
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace sim {
+
+struct Point {
+  double x;
+  double y;
+};
+
+// Position in mm and heading in radians, counter-clockwise from +x
+struct Pose {
+  double x;
+  double y;
+  double heading;
+};
+
+class TrackMap {
+public:
+  static constexpr double kTapeWidthMm = 19.0;
+  static constexpr double kMarkerLengthMm = 80.0;
+
+  void addLine(Point from, Point to);
+  void addArc(Point center, double radiusMm, double startDeg, double sweepDeg);
+  void addMarker(Pose at, double lengthMm = kMarkerLengthMm);
+
+  void setStart(Pose start) { start_ = start; }
+  const Pose &start() const { return start_; }
+
+  void setTapeWidthMm(double width) { tapeWidthMm_ = width; }
+  double tapeWidthMm() const { return tapeWidthMm_; }
+
+  bool empty() const { return pieces_.empty(); }
+
+  // Distance from p to the middle of the nearest piece of tape
+  double distanceToTape(Point p) const;
+
+  // Replace the map with one read from a stream or file. On failure the
+  // error names the line at fault.
+  bool load(std::istream &in, std::string &error);
+  bool loadFile(const std::string &path, std::string &error);
+
+private:
+  struct Piece {
+    bool arc;
+    Point a;        // Line start, or arc center
+    Point b;        // Line end, or arc start point
+    Point c;        // Arc end point
+    double radius;
+    double start;   // Arc start angle (radians)
+    double sweep;   // Arc sweep (radians)
+  };
+
+  std::vector<Piece> pieces_;
+  Pose start_ = {0, 0, 0};
+  double tapeWidthMm_ = kTapeWidthMm;
+};
+
+// A rounded-rectangle loop lengthMm around, run counter-clockwise from the
+// start (the middle of a long side), with markers the given distances
+// along it. Matches a layout that is one loop, like TRACK_LAYOUT 1.
+TrackMap loopTrack(double lengthMm, const std::vector<double> &markersAtMm);
+
+}  // namespace sim
+
+#endif
@@ -0,0 +1,108 @@
+// Smart Waiter Robot - Virtual Clock
+
+#include "virtual_clock.h"
+
+#include <utility>
+
+namespace sim {
+
+void VirtualClock::advance(uint64_t us) {
+  advanceTo(now_ + us);
+}
+
+void VirtualClock::advanceTo(uint64_t when) {
+  if (when <= now_) {
+    return;
+  }
+  if (advancing_ || when < nextDue_) {
+    now_ = when;
+    return;
+  }
+  advancing_ = true;
+  while (nextDue_ <= when) {
+    // Earliest event first; ties in the order they were scheduled
+    size_t index = 0;
+    for (size_t i = 1; i < events_.size(); i++) {
+      if (events_[i].when < events_[index].when) {
+        index = i;
+      }
+    }
+    Event &event = events_[index];
+    if (event.when > now_) {
+      now_ = event.when;
+    }
+    EventId id = event.id;
+    bool periodic = event.period != 0;
+    Callback callback = std::move(event.callback);
+    if (periodic) {
+      event.when += event.period;
+    } else {
+      events_.erase(events_.begin() + index);
+    }
+    callback();
+    // Put a periodic callback back, unless it cancelled itself
+    if (periodic) {
+      for (Event &again : events_) {
+        if (again.id == id) {
+          again.callback = std::move(callback);
+          break;
+        }
+      }
+    }
+    updateNextDue();
+    // A callback that held the clock (a delay() inside an interrupt, say)
+    // may have moved it past later events; they still run, late, in order
+    if (now_ > when) {
+      when = now_;
+    }
+  }
+  now_ = when;
+  advancing_ = false;
+}
+
+VirtualClock::EventId VirtualClock::at(uint64_t when, const Callback &callback) {
+  events_.push_back(Event{nextId_, when, 0, callback});
+  updateNextDue();
+  return nextId_++;
+}
+
+VirtualClock::EventId VirtualClock::every(uint64_t period, const Callback &callback,
+                                          uint64_t first) {
+  events_.push_back(Event{nextId_, first, period ? period : 1, callback});
+  updateNextDue();
+  return nextId_++;
+}
+
+void VirtualClock::cancel(EventId id) {
+  for (size_t i = 0; i < events_.size(); i++) {
+    if (events_[i].id == id) {
+      events_.erase(events_.begin() + i);
+      updateNextDue();
+      return;
+    }
+  }
+}
+
+bool VirtualClock::nextEvent(uint64_t &when) const {
+  when = nextDue_;
+  return !events_.empty();
+}
+
+void VirtualClock::updateNextDue() {
+  nextDue_ = kNever;
+  for (const Event &event : events_) {
+    if (event.when < nextDue_) {
+      nextDue_ = event.when;
+    }
+  }
+}
+
+void VirtualClock::reset() {
+  now_ = 0;
+  nextId_ = 1;
+  advancing_ = false;
+  events_.clear();
+  nextDue_ = kNever;
+}
+
+}  // namespace sim
@@ -0,0 +1,68 @@
+// Smart Waiter Robot - Virtual Clock
+// Simulated time for one board. It only moves when told to, so runs are
+// deterministic and as fast as the host can go: delay() jumps ahead at
+// once, and a simulation steps it pass by pass or runs it until something
+// happens. Events can be scheduled on it (once or periodically) and run
+// in time order as the clock passes them, even in the middle of a delay()
+// - the robot model's physics runs this way, so encoder interrupts still
+// arrive while the sketch is busy.
+//
+// Every board has its own clock; nothing here reads the wall clock.
+
+#ifndef SIM_VIRTUAL_CLOCK_H
+#define SIM_VIRTUAL_CLOCK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace sim {
+
+class VirtualClock {
+public:
+  typedef std::function<void()> Callback;
+  typedef uint64_t EventId;
+
+  uint64_t micros() const { return now_; }
+  unsigned long millis() const { return (unsigned long)(now_ / 1000); }
+
+  // Move time on, running every event that falls due on the way. An event
+  // that moves the clock itself only moves time; the events it passes run
+  // when the outer advance gets to them.
+  void advance(uint64_t us);
+  void advanceTo(uint64_t when);
+
+  // Run callback at `when`, or every `period` us from `when`
+  EventId at(uint64_t when, const Callback &callback);
+  EventId every(uint64_t period, const Callback &callback, uint64_t first = 0);
+  void cancel(EventId id);
+
+  // Time of the earliest pending event; false if there is none
+  bool nextEvent(uint64_t &when) const;
+
+  // Back to zero with no events
+  void reset();
+
+private:
+  static const uint64_t kNever = UINT64_MAX;
+
+  struct Event {
+    EventId id;
+    uint64_t when;
+    uint64_t period;
+    Callback callback;
+  };
+
+  uint64_t now_ = 0;
+  EventId nextId_ = 1;
+  bool advancing_ = false;
+  std::vector<Event> events_;
+  uint64_t nextDue_ = kNever;  // Earliest event, so most advances are cheap
+
+  void updateNextDue();
+};
+
+}  // namespace sim
+
+#endif
@@ -0,0 +1,168 @@
+// Smart Waiter Robot - Fleet Simulator
+// Plays one script on many simulated robots at once, each a separate copy
+// of the firmware with its own clock (firmware_instance.h), and each with
+// its own sensor noise seed. Shows whether a change holds up beyond the
+// one run waiter_sim gives: how many runs pass and how long they take.
+//
+// usage: waiter_fleet [options] [script]    (script defaults to stdin)
+//   --runs N        robots to run (default 10)
+//   --jobs N        run this many at a time (default: one per CPU)
+//   --map FILE      track map; default: the compiled-in layout as a loop
+//   --noise N       sensor noise, +/- raw counts (default 20)
+//   --seed N        noise seed of the first run; run i uses seed + i
+//   --step-us N     clock step per loop() pass
+//   --module FILE   firmware module (default: the one built with this tool)
+//   --log           print every run's log, not only those that failed
+//
+// The exit status is 1 if any run failed.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "firmware_instance.h"
+
+namespace {
+
+struct Run {
+  uint32_t seed = 0;
+  WaiterRunResult result = {2, 0, 0};
+  double wallSeconds = 0;
+  std::string log;
+};
+
+bool readFile(const std::string &path, std::string &text) {
+  std::ifstream in(path);
+  if (!in) {
+    return false;
+  }
+  std::ostringstream contents;
+  contents << in.rdbuf();
+  text = contents.str();
+  return true;
+}
+
+void usage() {
+  std::fprintf(stderr,
+               "usage: waiter_fleet [--runs N] [--jobs N] [--map FILE] [--noise N] [--seed N] "
+               "[--step-us N] [--module FILE] [--log] [script]\n");
+  std::exit(2);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  int runCount = 10;
+  int jobs = (int)std::thread::hardware_concurrency();
+  std::string mapPath;
+  std::string scriptPath;
+  std::string modulePath = WAITER_FIRMWARE_MODULE;
+  bool showAllLogs = false;
+  WaiterRunOptions options = {nullptr, nullptr, 20, 1, 0, 0};
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--runs" && hasValue) {
+      runCount = std::atoi(argv[++i]);
+    } else if (arg == "--jobs" && hasValue) {
+      jobs = std::atoi(argv[++i]);
+    } else if (arg == "--map" && hasValue) {
+      mapPath = argv[++i];
+    } else if (arg == "--noise" && hasValue) {
+      options.sensorNoise = std::atoi(argv[++i]);
+    } else if (arg == "--seed" && hasValue) {
+      options.noiseSeed = (uint32_t)std::strtoul(argv[++i], nullptr, 10);
+    } else if (arg == "--step-us" && hasValue) {
+      options.stepMicros = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--module" && hasValue) {
+      modulePath = argv[++i];
+    } else if (arg == "--log") {
+      showAllLogs = true;
+    } else if (arg.size() > 1 && arg[0] == '-') {
+      usage();
+    } else if (scriptPath.empty()) {
+      scriptPath = arg;
+    } else {
+      usage();
+    }
+  }
+  if (runCount < 1) {
+    usage();
+  }
+  if (jobs < 1) {
+    jobs = 1;
+  }
+
+  std::string map;
+  if (!mapPath.empty() && !readFile(mapPath, map)) {
+    std::fprintf(stderr, "waiter_fleet: cannot open %s\n", mapPath.c_str());
+    return 2;
+  }
+  std::string script;
+  if (scriptPath.empty()) {
+    script.assign(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>());
+  } else if (!readFile(scriptPath, script)) {
+    std::fprintf(stderr, "waiter_fleet: cannot open %s\n", scriptPath.c_str());
+    return 2;
+  }
+  options.map = mapPath.empty() ? nullptr : map.c_str();
+  options.script = script.c_str();
+
+  // Runs are handed out one at a time; every run gets a fresh instance, as
+  // the sketch's globals only start clean once
+  std::vector<Run> runs(runCount);
+  std::atomic<int> next(0);
+  auto worker = [&]() {
+    for (int i = next++; i < runCount; i = next++) {
+      Run &run = runs[i];
+      WaiterRunOptions runOptions = options;
+      run.seed = runOptions.noiseSeed = options.noiseSeed + (uint32_t)i;
+      auto started = std::chrono::steady_clock::now();
+      sim::FirmwareInstance instance(modulePath);
+      run.result = instance.run(runOptions, run.log);
+      run.wallSeconds =
+          std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    }
+  };
+
+  auto started = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (int i = 0; i < jobs && i < runCount; i++) {
+    threads.emplace_back(worker);
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+  double wallSeconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+  int passed = 0;
+  double simulatedSeconds = 0;
+  std::printf("run       seed  result    sim_s  travelled_mm  wall_ms\n");
+  for (int i = 0; i < runCount; i++) {
+    const Run &run = runs[i];
+    const char *result = run.result.status == 0 ? "pass" : run.result.status == 1 ? "FAIL" : "error";
+    std::printf("%3d %10u  %-6s %8.3f  %12.0f  %7.0f\n", i + 1, run.seed, result,
+                run.result.micros / 1e6, run.result.travelledMm, run.wallSeconds * 1e3);
+    passed += run.result.status == 0;
+    simulatedSeconds += run.result.micros / 1e6;
+  }
+  for (int i = 0; i < runCount; i++) {
+    if (showAllLogs || runs[i].result.status != 0) {
+      std::printf("\n--- run %d (seed %u)\n%s", i + 1, runs[i].seed, runs[i].log.c_str());
+    }
+  }
+  std::printf("\n%d/%d passed, %.1f s simulated in %.2f s (%.0fx real time)\n", passed, runCount,
+              simulatedSeconds, wallSeconds,
+              wallSeconds > 0 ? simulatedSeconds / wallSeconds : 0.0);
+  return passed == runCount ? 0 : 1;
+}
@@ -0,0 +1,146 @@
+// Smart Waiter Robot - Robot Process
+// Runs the unmodified firmware on the simulated robot and track in real
+// time, as a Linux process other programs can talk to: the Bluetooth port
+// is a pseudo-terminal (pty_port.h) and the USB serial port is stdin and
+// stdout. Point a terminal, a pyserial script or a gateway at the device it
+// prints (or at --link PATH) as if it were the robot's /dev/rfcomm0.
+//
+// usage: waiter_robot [options]
+//   --link PATH     also make the Bluetooth pty reachable as PATH
+//   --map FILE      track map (sim/track_map.h); default: the compiled-in
+//                   layout laid out as a loop, if it is one
+//   --speed X       run X times faster than real time (default 1)
+//   --noise N       sensor noise, +/- raw counts
+//   --seed N        sensor noise seed
+//
+// Runs until interrupted. The clock is still the board's virtual clock,
+// only paced against the wall clock, so millis() and Stream timeouts
+// behave exactly as in waiter_sim.
+
+#include <poll.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "pty_port.h"
+#include "script_runner.h"
+#include "simulation.h"
+#include "track_map.h"
+
+namespace {
+
+volatile std::sig_atomic_t stopRequested = 0;
+
+void requestStop(int) {
+  stopRequested = 1;
+}
+
+void usage() {
+  std::fprintf(stderr,
+               "usage: waiter_robot [--link PATH] [--map FILE] [--speed X] [--noise N] "
+               "[--seed N]\n");
+  std::exit(2);
+}
+
+// USB serial: stdin to the sketch, the sketch's output to stdout. Stops
+// reading at end of input, but the robot keeps running.
+void pumpUsb(sim::VirtualPort &port, bool &stdinOpen) {
+  char incoming[256];
+  while (stdinOpen) {
+    pollfd ready = {STDIN_FILENO, POLLIN, 0};
+    if (::poll(&ready, 1, 0) <= 0) {
+      break;
+    }
+    ssize_t count = ::read(STDIN_FILENO, incoming, sizeof(incoming));
+    if (count <= 0) {
+      stdinOpen = false;
+      break;
+    }
+    port.send(reinterpret_cast<const uint8_t *>(incoming), (size_t)count);
+  }
+  std::string output = port.takeOutput();
+  if (!output.empty()) {
+    std::fwrite(output.data(), 1, output.size(), stdout);
+    std::fflush(stdout);
+  }
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  std::string linkPath;
+  std::string mapPath;
+  double speed = 1;
+  sim::RobotParameters parameters;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--link" && hasValue) {
+      linkPath = argv[++i];
+    } else if (arg == "--map" && hasValue) {
+      mapPath = argv[++i];
+    } else if (arg == "--speed" && hasValue) {
+      speed = std::atof(argv[++i]);
+    } else if (arg == "--noise" && hasValue) {
+      parameters.sensorNoise = std::atoi(argv[++i]);
+    } else if (arg == "--seed" && hasValue) {
+      parameters.noiseSeed = (uint32_t)std::strtoul(argv[++i], nullptr, 10);
+    } else {
+      usage();
+    }
+  }
+  if (speed <= 0) {
+    usage();
+  }
+
+  sim::TrackMap track;
+  std::string error;
+  if (mapPath.empty() ? !sim::layoutTrack(track, error) : !track.loadFile(mapPath, error)) {
+    std::fprintf(stderr, "waiter_robot: %s\n", error.c_str());
+    return 2;
+  }
+
+  sim::PtyPort bluetooth;
+  if (!bluetooth.open(error) || (!linkPath.empty() && !bluetooth.link(linkPath, error))) {
+    std::fprintf(stderr, "waiter_robot: %s\n", error.c_str());
+    return 1;
+  }
+  std::fprintf(stderr, "waiter_robot: Bluetooth on %s%s%s\n", bluetooth.path().c_str(),
+               linkPath.empty() ? "" : " -> ", linkPath.c_str());
+
+  std::signal(SIGINT, requestStop);
+  std::signal(SIGTERM, requestStop);
+
+  sim::Simulation simulation(track, parameters);
+  simulation.start();
+  bool stdinOpen = true;
+
+  // Keep the virtual clock level with the wall clock (times speed), then
+  // sleep until either clock has something to do
+  typedef std::chrono::steady_clock WallClock;
+  WallClock::time_point wallStart = WallClock::now();
+  uint64_t simStart = simulation.micros();
+  while (!stopRequested) {
+    uint64_t wallMicros = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+                              WallClock::now() - wallStart)
+                              .count();
+    uint64_t target = simStart + (uint64_t)(wallMicros * speed);
+    while (simulation.micros() < target) {
+      simulation.step();
+    }
+    bluetooth.pump(simulation.bluetooth());
+    pumpUsb(simulation.serial(), stdinOpen);
+
+    pollfd ready[2] = {{bluetooth.fd(), POLLIN, 0}, {STDIN_FILENO, POLLIN, 0}};
+    ::poll(ready, stdinOpen ? 2 : 1, 1);
+  }
+
+  std::fprintf(stderr, "waiter_robot: stopped at %.3f s, %.0f mm travelled\n",
+               simulation.micros() / 1e6, simulation.robot().travelledMm());
+  return 0;
+}
@@ -0,0 +1,134 @@
+// Smart Waiter Robot - Simulator
+// Runs the unmodified firmware on a simulated robot and track and plays a
+// script of Bluetooth commands at it, printing every reply with its
+// simulated time. Seconds of robot time take milliseconds, so tuning and
+// regression runs can be repeated at a desk.
+//
+// usage: waiter_sim [options] [script]      (script defaults to stdin)
+//   --map FILE      track map (sim/track_map.h); default: the compiled-in
+//                   layout laid out as a loop, if it is one
+//   --trace FILE    write the robot's path as CSV, every 10 ms
+//   --serial        also print the USB serial log
+//   --step-us N     clock step per loop() pass (default 50)
+//   --physics-us N  robot model step (default 250)
+//   --noise N       sensor noise, +/- raw counts
+//   --seed N        sensor noise seed
+//
+// The script language is in script_runner.h. The exit status is 1 if an
+// `until` timed out or the firmware allocated heap memory after setup(),
+// so scripts can be used as regression checks.
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "script_runner.h"
+#include "simulation.h"
+#include "track_map.h"
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+
+void usage() {
+  std::fprintf(stderr,
+               "usage: waiter_sim [--map FILE] [--trace FILE] [--serial] [--step-us N] "
+               "[--physics-us N] [--noise N] [--seed N] [script]\n");
+  std::exit(2);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  std::string mapPath;
+  std::string tracePath;
+  std::string scriptPath;
+  bool showSerial = false;
+  uint64_t stepMicros = sim::Simulation::kDefaultStepMicros;
+  uint64_t physicsMicros = sim::Simulation::kDefaultPhysicsMicros;
+  sim::RobotParameters parameters;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--map" && hasValue) {
+      mapPath = argv[++i];
+    } else if (arg == "--trace" && hasValue) {
+      tracePath = argv[++i];
+    } else if (arg == "--step-us" && hasValue) {
+      stepMicros = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--physics-us" && hasValue) {
+      physicsMicros = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--noise" && hasValue) {
+      parameters.sensorNoise = std::atoi(argv[++i]);
+    } else if (arg == "--seed" && hasValue) {
+      parameters.noiseSeed = (uint32_t)std::strtoul(argv[++i], nullptr, 10);
+    } else if (arg == "--serial") {
+      showSerial = true;
+    } else if (arg.size() > 1 && arg[0] == '-') {
+      usage();
+    } else if (scriptPath.empty()) {
+      scriptPath = arg;
+    } else {
+      usage();
+    }
+  }
+
+  sim::TrackMap track;
+  std::string error;
+  if (mapPath.empty() ? !sim::layoutTrack(track, error) : !track.loadFile(mapPath, error)) {
+    std::fprintf(stderr, "waiter_sim: %s\n", error.c_str());
+    return 2;
+  }
+
+  std::ifstream scriptFile;
+  if (!scriptPath.empty()) {
+    scriptFile.open(scriptPath);
+    if (!scriptFile) {
+      std::fprintf(stderr, "waiter_sim: cannot open %s\n", scriptPath.c_str());
+      return 2;
+    }
+  }
+  std::istream &script = scriptPath.empty() ? std::cin : scriptFile;
+
+  FILE *trace = nullptr;
+  if (!tracePath.empty()) {
+    trace = std::fopen(tracePath.c_str(), "w");
+    if (!trace) {
+      std::fprintf(stderr, "waiter_sim: cannot write %s\n", tracePath.c_str());
+      return 2;
+    }
+    std::fprintf(trace, "t_ms,x_mm,y_mm,heading_deg,speed_mm_s,left_pwm,right_pwm\n");
+  }
+
+  sim::Simulation simulation(track, parameters);
+  simulation.setStepMicros(stepMicros);
+  simulation.setPhysicsMicros(physicsMicros);
+  sim::ScriptRunner runner(simulation, std::cout);
+  runner.setShowSerial(showSerial);
+  uint64_t nextTraceMicros = 0;
+  if (trace) {
+    runner.setObserver([&]() {
+      if (simulation.micros() < nextTraceMicros) {
+        return;
+      }
+      const sim::Pose &pose = simulation.robot().pose();
+      std::fprintf(trace, "%.1f,%.1f,%.1f,%.1f,%.0f,%d,%d\n", simulation.micros() / 1e3, pose.x,
+                   pose.y, pose.heading * 180 / kPi, simulation.robot().speedMmS(),
+                   simulation.robot().leftPwm(simulation.board()),
+                   simulation.robot().rightPwm(simulation.board()));
+      nextTraceMicros = (simulation.micros() / 10000 + 1) * 10000;
+    });
+  }
+
+  int status = runner.run(script) ? 0 : 1;
+
+  if (trace) {
+    std::fclose(trace);
+  }
+  std::printf("%9.3f end, %.0f mm travelled\n", simulation.micros() / 1e6,
+              simulation.robot().travelledMm());
+  return status;
+}
@@ -1,14 +1,98 @@
 // Smart Waiter Robot - Arduino Code
-// Compatible with Arduino IDE and standard libraries only
+// Compatible with Arduino IDE and standard libraries only. The protocols
+// and optional features built in are chosen in firmware_config.h.
 
 // Include Arduino definitions for VS Code IntelliSense
 #include "arduino_stub.h"
 
-// Include path: libraries/SoftwareSerial/SoftwareSerial.h
+// Off the robot: sim/core/SoftwareSerial.h
 #include <SoftwareSerial.h>
+#include <EEPROM.h>
+
+#include "firmware_config.h"
+#include "task_scheduler.h"
+#include "line_reader.h"
+#include "command_parser.h"
+#include "robot_protocol.h"
+#include "reply_builder.h"
+#include "line_tracker.h"
+#include "adc_sampler.h"
+#include "sensor_calibration.h"
+#include "wheel_odometry.h"
+#include "track_markers.h"
+#include "track_layout.h"
+#include "delivery_planner.h"
+#include "command_queue.h"
+#include "motion_profile.h"
+#include "curve_speed.h"
+#include "telemetry_stream.h"
 
 // Bluetooth Serial object
-SoftwareSerial bluetooth(2, 3); // RX, TX pins
+// (pins 2 and 3 are the wheel encoder interrupts)
+SoftwareSerial bluetooth(11, 12); // RX, TX pins
+
+// Incoming command assembler (64-byte ring, commands up to 96 chars)
+LineReader<64, 96> bluetoothReader;
+// Times SoftwareSerial's receive buffer overflowed and dropped bytes
+unsigned long rxOverflows = 0;
+BasicCommandParser<Firmware::jsonCommands, Firmware::textCommands> commandParser;
+
+// Replies and events use the format of the most recent command
+bool binaryLink = false;
+bool usbCommand = false;  // The command being run came from USB serial
+
+// Every reply is rendered on the stack and sent with one write. Sized for
+// the replies below with every field at its widest; a longer reply (only a
+// METRICS summary with every timing in the seconds) drops its last fields
+// and ends with "truncated":true (reply_builder.h)
+typedef ReplyBuilder<kReplyCapacity> Reply;
+const unsigned int kStatusReplyBytes = 2 +
+  replyFieldBytes("state", replyTextBytes("returning_home")) +
+  replyFieldBytes("current_table", kReplyIntBytes) +
+  replyFieldBytes("target_table", kReplyIntBytes) +
+  replyFieldBytes("is_at_home", kReplyBoolBytes) +
+  replyFieldBytes("progress", kReplyIntBytes) +
+  replyFieldBytes("eta_ms", kReplyLongBytes) +
+  replyFieldBytes("command", replyTextBytes("status")) + 2;
+const unsigned int kMetricsReplyBytes = 2 +
+  replyFieldBytes("status", replyTextBytes("metrics")) +
+  replyFieldBytes("reset", kReplyBoolBytes) +
+  replyFieldBytes("command", replyTextBytes("metrics")) + 2;
+const unsigned int kTimingSectionReplyBytes = kMetricsReplyBytes +
+  replyFieldBytes("section", replyTextBytes("telemetry")) +
+  replyFieldBytes("count", kReplyULongBytes) +
+  replyFieldBytes("min", kReplyULongBytes) +
+  replyFieldBytes("mean", kReplyULongBytes) +
+  replyFieldBytes("max", kReplyULongBytes) +
+  replyFieldBytes("misses", kReplyULongBytes) +
+  replyFieldBytes("hist", 2 + kTimingBuckets * 6 - 1);
+const unsigned int kLinkSectionReplyBytes = kMetricsReplyBytes +
+  replyFieldBytes("section", replyTextBytes("link")) +
+  replyFieldBytes("rx_overflows", kReplyULongBytes) +
+  replyFieldBytes("rx_too_long", kReplyULongBytes) +
+  replyFieldBytes("tx_us", kReplyULongBytes) +
+  replyFieldBytes("tx_truncated", kReplyULongBytes);
+const unsigned int kRobotSectionReplyBytes = kMetricsReplyBytes +
+  replyFieldBytes("section", replyTextBytes("robot")) +
+  replyFieldBytes("line_position", kReplyIntBytes) +
+  replyFieldBytes("curvature", kReplyIntBytes) +
+  replyFieldBytes("calibrated", kReplyBoolBytes) +
+  replyFieldBytes("distance_mm", kReplyLongBytes) +
+  replyFieldBytes("speed_mm_s", kReplyLongBytes) +
+  replyFieldBytes("markers", kReplyIntBytes) +
+  replyFieldBytes("node", kReplyIntBytes);
+static_assert(kStatusReplyBytes + kReplyTailBytes <= kReplyCapacity,
+              "reply: a status must fit; keep this in step with sendStatus()");
+static_assert(kTimingSectionReplyBytes + kReplyTailBytes <= kReplyCapacity &&
+              kLinkSectionReplyBytes + kReplyTailBytes <= kReplyCapacity &&
+              kRobotSectionReplyBytes + kReplyTailBytes <= kReplyCapacity,
+              "reply: a METRICS section must fit; keep this in step with sendMetrics()");
+unsigned long lastReplyMicros = 0; // Time spent writing the last reply
+unsigned long replyTruncations = 0; // Replies sent without some fields
+
+// Loop, task and reply timings for METRICS, left out with the command
+typedef TimingStatsFor<Firmware::metrics>::Type TaskStats;
+TaskStats replyStats;
 
 // Motor pins (Arduino Uno compatible PWM pins)
 const int leftMotorPin1 = 5;   // PWM pin
@@ -16,12 +100,53 @@ const int leftMotorPin2 = 6;   // PWM pin
 const int rightMotorPin1 = 9;  // PWM pin
 const int rightMotorPin2 = 10; // PWM pin
 const int motorSpeed = 200;    // PWM speed (0-255)
+int leftMotorPwm = 0;          // Signed PWM last set, for telemetry
+int rightMotorPwm = 0;
 
-// Line following sensor pins
+// PID steering; gains and base speed can be changed with the TUNE command
+LineTracker lineTracker(motorSpeed);
+const unsigned long lineLostTimeout = 300; // ms without a line before stopping
+const unsigned long lineLostFailTime = 3000; // ms before giving up the journey
+unsigned long lineLastSeenTime = 0;
+
+// Speed ramps: accelerate from standstill, cruise at the TUNE speed and
+// brake to a creep before the stop (motion_profile.h)
+MotionProfile motionProfile;
+const long accelerationMmS2 = 500;
+const long decelerationMmS2 = 400;
+const long creepSpeedMmS = 60;      // Speed the stop is reached at
+const int motorStartPwm = 50;       // PWM at which the wheels start turning
+const long fullSpeedMmS = 700;      // Speed at PWM 255
+
+// Slower in curves: the cruise speed is scaled by a speed-vs-curvature
+// table, changed with the CURVE command (curve_speed.h)
+CurveSpeed curveSpeed;
+
+// Line following sensor pins (must be consecutive analog pins)
 const int leftSensor = A0;     // Analog pin A0
 const int centerSensor = A1;   // Analog pin A1  
 const int rightSensor = A2;    // Analog pin A2
 
+// Sensors are sampled in the background by the ADC interrupt. Use
+// ADC_PRESCALER_32 with 8-bit mode for faster, slightly coarser readings.
+AdcSampler lineSensors(leftSensor);
+AdcSnapshot lineSample = {{0, 0, 0}, 0, 0};
+
+// Per-sensor normalization, measured by CALIBRATE and kept in EEPROM
+SensorCalibration sensorCalibration;
+const int calibrationAddress = 0;           // EEPROM offset
+const int calibrationSpeed = 120;           // PWM while sweeping
+const unsigned long calibrationTime = 4000; // ms: left 1 s, right 2 s, left 1 s
+unsigned long calibrationStartTime = 0;
+
+// Wheel encoders (external interrupts INT0/INT1)
+const int leftEncoderPin = 2;
+const int rightEncoderPin = 3;
+
+// 65 mm wheel (204 mm around), 20-slot disc counted on both edges
+const unsigned int encoderMicronsPerTick = 5105;
+WheelOdometry odometry(encoderMicronsPerTick);
+
 // LED indicator
 const int ledPin = 13;         // Built-in LED
 
@@ -30,7 +155,8 @@ enum RobotState {
   IDLE,
   GOING_TO_TABLE,
   AT_TABLE,
-  RETURNING_HOME
+  RETURNING_HOME,
+  CALIBRATING
 };
 
 RobotState currentState = IDLE;
@@ -38,241 +164,1085 @@ int targetTable = 0;
 int currentTable = 0;
 bool isAtHome = true;
 
-// Table distances in milliseconds of travel time
-int tableDistances[] = {0, 5000, 8000, 12000, 15000, 18000};
-unsigned long journeyStartTime = 0;
+// Current journey through the track layout (track_layout.h). Its route is
+// read from a precomputed flash table; the branch to take at each junction
+// is handed to the line tracker as the junction's marker is crossed.
+RouteFollower journey;
+RoutePlan journeyPlan;
+const long branchDistanceMm = 250; // Keep to the chosen side past a junction
+long branchEndMm = 0;
+
+// Motion commands waiting for the current job to finish. The next one
+// starts when the robot is idle, or after the dwell at a table.
+CommandQueue jobQueue;
+
+// Multi-stop delivery run (DELIVER): the tables in visiting order, and how
+// long to wait at each before moving on
+DeliveryPlanner delivery;
+const unsigned long stopDwellTime = 8000; // ms
+unsigned long dwellStartTime = 0;
+
+// Where the robot is: the last station (layout node and heading) it
+// stopped at or passed, the odometry distance there, and the next station
+// on the segment it is on, with that segment's length. Journeys are
+// planned from here, so the robot goes straight from table to table.
+unsigned char currentStation = trackStation(kHomeNode, HEADING_FORWARD);
+long stationDistanceMm = 0;
+unsigned char nextStation = currentStation;
+long segmentMm = 0;
+bool atStation = true;
+
+// Turning round on the spot when the route starts the other way: spin
+// until the center sensor has left the line and found it again. The time
+// counts from the first spin, not from the command: a long reply can hold
+// up the loop for well over a tenth of a second.
+const int turnAroundSpeed = 140;
+const unsigned long turnAroundMinTime = 300; // ms before the line may count
+const unsigned long turnAroundTimeout = 4000;
+const int turnLineOn = 600;                  // Center sensor darkness
+const int turnLineOff = 400;
+bool turningAround = false;
+bool turnLeftLine = false;
+bool turnStarted = false;
+unsigned long turnStartTime = 0;
+
+// Cross-line markers counted since the start of the journey, and the layout
+// node each stop is at (set with MARKER, kept in EEPROM). Without its
+// destination by 150% of the route length, the robot stops rather than
+// running on.
+MarkerDetector markerDetector;
+MarkerMap markerMap;
+const int markerMapAddress = 32;      // EEPROM offset, after the calibration
+const int markerSearchPercent = 150;
+
+// Scheduler task table (periods in microseconds). Line following runs at
+// 1 kHz on the latest ADC round, commands are polled every 10 ms so STOP is
+// seen within one tick.
+void lineFollowTask();
+void commsTask();
+void arrivalTask();
+void ledTask();
+void telemetryTask();
+
+// The telemetry task comes last so it can be left out of the table
+BasicTask<TaskStats> tasks[] = {
+  {"line",      lineFollowTask,  1000UL, 0, 0, {}},
+  {"comms",     commsTask,      10000UL, 0, 0, {}},
+  {"arrival",   arrivalTask,    20000UL, 0, 0, {}},
+  {"led",       ledTask,        50000UL, 0, 0, {}},
+  {"telemetry", telemetryTask,  10000UL, 0, 0, {}}
+};
+BasicTaskScheduler<TaskStats> scheduler(tasks, sizeof(tasks) / sizeof(tasks[0]) - (Firmware::telemetry ? 0 : 1),
+                                        Firmware::metrics ? micros : 0);
+
+// METRICS sections: 0 is a summary of the timings, then the loop period,
+// each task's run time in table order and the reply writes, then the link
+// and robot counters
+const unsigned char kMetricsLoop = 1;
+const unsigned char kMetricsFirstTask = 2;
+
+// SUBSCRIBE: telemetry frames pushed at a fixed rate (telemetry_stream.h).
+// The stream has its own sensor snapshot so it never takes a round from
+// followLine().
+TelemetryStream telemetry;
+AdcSnapshot telemetrySample = {{0, 0, 0}, 0, 0};
+unsigned long telemetryPasses = 0;  // Loop passes and time at the last frame
+unsigned long telemetryMicros = 0;
 
 void setup() {
   Serial.begin(9600);
   
   // Initialize Bluetooth
   bluetooth.begin(9600);
-  Serial.println("Smart Waiter Robot Ready!");
-  Serial.println("Waiting for Bluetooth connection...");
+  Serial.println(F("Smart Waiter Robot Ready!"));
+  Serial.println(F("Waiting for Bluetooth connection..."));
   
   // Initialize motor pins
   pinMode(leftMotorPin1, OUTPUT);
   pinMode(leftMotorPin2, OUTPUT);
   pinMode(rightMotorPin1, OUTPUT);
   pinMode(rightMotorPin2, OUTPUT);
+  motionProfile.setLimits(accelerationMmS2, decelerationMmS2, creepSpeedMmS);
+  motionProfile.setMotorModel(motorStartPwm, fullSpeedMmS);
   
   // Initialize LED
   pinMode(ledPin, OUTPUT);
   
+  // Count wheel encoder edges in the background
+  pinMode(leftEncoderPin, INPUT_PULLUP);
+  pinMode(rightEncoderPin, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(leftEncoderPin), leftEncoderISR, CHANGE);
+  attachInterrupt(digitalPinToInterrupt(rightEncoderPin), rightEncoderISR, CHANGE);
+  
+  // Start background sensor sampling with the stored calibration
+  loadCalibration();
+  loadMarkerMap();
+  lineSensors.begin(ADC_PRESCALER_128, false);
+  
   // Start at home
   stopMotors();
   digitalWrite(ledPin, HIGH);
   
-  Serial.println("Robot initialized and ready!");
+  scheduler.begin(micros());
+  Serial.println(F("Robot initialized and ready!"));
 }
 
 void loop() {
-  // Check for Bluetooth commands
-  if (bluetooth.available()) {
-    String command = bluetooth.readStringUntil('\n');
-    command.trim();
-    processCommand(command);
+  // Run whichever tasks are due; never blocks
+  scheduler.run(micros());
+}
+
+// Push a telemetry frame when one is due. Frames are always binary, so
+// they can be told apart from JSON replies on the same link.
+void telemetryTask() {
+  if (!Firmware::telemetry || !telemetry.due(millis())) {
+    return;
   }
+  lineSensors.snapshot(telemetrySample);
+  
+  // Mean loop period since the last frame (0 right after METRICS reset)
+  unsigned long passes = scheduler.passStats().count();
+  unsigned long now = micros();
+  long loopMicros = passes > telemetryPasses
+                  ? (long)((now - telemetryMicros) / (passes - telemetryPasses)) : 0;
+  telemetryPasses = passes;
+  telemetryMicros = now;
+  
+  long values[kTelemetryFields];
+  values[TELEMETRY_SENSOR_LEFT] = telemetrySample.value[0];
+  values[TELEMETRY_SENSOR_CENTER] = telemetrySample.value[1];
+  values[TELEMETRY_SENSOR_RIGHT] = telemetrySample.value[2];
+  values[TELEMETRY_LINE_POSITION] = lineTracker.position();
+  values[TELEMETRY_LEFT_PWM] = leftMotorPwm;
+  values[TELEMETRY_RIGHT_PWM] = rightMotorPwm;
+  values[TELEMETRY_STATE] = currentState;
+  values[TELEMETRY_TARGET_TABLE] = targetTable;
+  values[TELEMETRY_PROGRESS] = journeyDistanceMm() ? odometry.progressPercent(journeyDistanceMm()) : 0;
+  values[TELEMETRY_LOOP_US] = loopMicros;
   
-  // Execute current state behavior
+  FrameBuilder frame;
+  telemetry.encode(values, frame);
+  Reply reply;
+  reply.frame(frame);
+  sendReply(reply);
+}
+
+// Drive the motors for the current state
+void lineFollowTask() {
   switch (currentState) {
-    case IDLE:
-      stopMotors();
-      break;
-      
     case GOING_TO_TABLE:
+    case RETURNING_HOME:
       followLine();
-      checkTableArrival();
       break;
       
-    case AT_TABLE:
-      stopMotors();
-      blinkLED();
+    case CALIBRATING:
+      calibrationSweep();
       break;
       
-    case RETURNING_HOME:
-      followLine();
-      checkHomeArrival();
+    case IDLE:
+    case AT_TABLE:
+      stopMotors();
       break;
   }
+}
+
+// Check for Bluetooth commands without waiting for partial lines
+void commsTask() {
+  bluetoothReader.poll(bluetooth);
+  if (bluetooth.overflow()) {
+    rxOverflows++;
+  }
+  while (bluetoothReader.readLine()) {
+    if (!bluetoothReader.lineIsBinary()) {
+      processCommand(bluetoothReader.line(), bluetoothReader.lineSize());
+    } else if (Firmware::binaryFrames) {
+      processFrame(bluetoothReader.frame(), bluetoothReader.lineSize());
+    }
+  }
+  if (Firmware::usbCommands) {
+    pollUsbCommands();
+  }
+}
+
+// Commands typed on USB serial (SimpleFirmware). Their replies go back to
+// USB; events still go to Bluetooth.
+void pollUsbCommands() {
+  static LineReader<64, 96> usbReader;
+  usbReader.poll(Serial);
+  while (usbReader.readLine()) {
+    if (!usbReader.lineIsBinary()) {
+      usbCommand = true;
+      processCommand(usbReader.line(), usbReader.lineSize());
+      usbCommand = false;
+    }
+  }
+}
+
+// Update odometry and check whether the current journey has finished
+void arrivalTask() {
+  odometry.update(millis());
+  
+  if ((currentState == GOING_TO_TABLE || currentState == RETURNING_HOME) && !turningAround) {
+    checkJourneyArrival();
+  }
+  else if (currentState == AT_TABLE && delivery.active() &&
+           millis() - dwellStartTime >= stopDwellTime) {
+    leaveDeliveryStop();
+  }
   
-  delay(50); // Small delay for stability
+  if (!jobQueue.empty() && readyForNextJob()) {
+    runNextJob();
+  }
 }
 
-void processCommand(String command) {
-  Serial.print("Received command: ");
-  Serial.println(command);
+// Blink the status LED while waiting at a table
+void ledTask() {
+  if (currentState == AT_TABLE) {
+    blinkLED();
+  }
+}
+
+void processCommand(const char *line, unsigned int length) {
+  Serial.print(F("Received command: "));
+  Serial.println(line);
   
-  // Simple command parsing - supports both JSON and text commands
-  String cmd = "";
-  int tableNumber = 0;
+  // Parse JSON or simple text commands into a fixed struct (no heap use)
+  RobotCommand command;
+  if (!commandParser.parse(line, length, command)) {
+    command.id = CMD_UNKNOWN;
+  }
+  binaryLink = false;
   
-  // Parse JSON or simple text commands
-  if (command.indexOf("go_to_table") >= 0) {
-    cmd = "go_to_table";
-    // Extract table number from JSON
-    int start = command.indexOf("table_number");
-    if (start >= 0) {
-      start = command.indexOf(":", start) + 1;
-      int end = command.indexOf(",", start);
-      if (end == -1) end = command.indexOf("}", start);
-      if (end == -1) end = command.length();
-      String numStr = command.substring(start, end);
-      numStr.trim();
-      numStr.replace("\"", ""); // Remove quotes
-      tableNumber = numStr.toInt();
-    }
+  // One JSON line per command: the command's own reply fields plus the
+  // "command" acknowledgment field
+  Reply reply;
+  reply.beginObject();
+  ReplyResult result = dispatchCommand(command, reply);
+  if (result == RESULT_INVALID_ARGUMENT) {
+    reply.field(F("status"), F("error"));
+    reply.field(F("error"), invalidArgumentText(command.id));
+  }
+  else if (result == RESULT_QUEUE_FULL) {
+    reply.field(F("status"), F("error"));
+    reply.field(F("error"), F("Queue full"));
+  }
+  else if (result == RESULT_UNKNOWN_COMMAND) {
+    reply.field(F("status"), F("error"));
+    reply.field(F("error"), F("Unknown command"));
+  }
+  reply.field(F("command"), commandName(command.id));
+  reply.endObject();
+  sendReply(reply);
+}
+
+// Binary frame (COBS block between 0x00 delimiters), decoded in place
+void processFrame(unsigned char *frame, unsigned int length) {
+  FrameReader reader;
+  Reply reply;
+  binaryLink = true;
+  if (!reader.open(frame, length)) {
+    Serial.println(F("Received bad frame"));
+    FrameBuilder error;
+    error.begin(REPLY_ERROR);
+    error.add(RESULT_BAD_FRAME);
+    reply.frame(error);
+    sendReply(reply);
+    return;
+  }
+  
+  RobotCommand command;
+  command.id = reader.opcode() > CMD_NONE && reader.opcode() < CMD_UNKNOWN
+             ? (CommandId)reader.opcode() : CMD_UNKNOWN;
+  command.argCount = 0;
+  command.argMask = 0;
+  long value;
+  while (command.argCount < kMaxCommandArgs && reader.next(value)) {
+    command.argMask |= 1 << command.argCount;
+    command.args[command.argCount++] = commandArgument(value);
   }
-  else if (command.indexOf("return_home") >= 0) {
-    cmd = "return_home";
+  for (unsigned char i = command.argCount; i < kMaxCommandArgs; i++) {
+    command.args[i] = 0;
   }
-  else if (command.indexOf("stop") >= 0) {
-    cmd = "stop";
+  
+  Serial.print(F("Received frame: "));
+  Serial.println(commandName(command.id));
+  
+  // Reply frame (if any) and acknowledgment go out in the same write
+  ReplyResult result = dispatchCommand(command, reply);
+  FrameBuilder ack;
+  ack.begin(REPLY_ACK);
+  ack.add(command.id);
+  ack.add(result);
+  reply.frame(ack);
+  sendReply(reply);
+}
+
+// Run a command now, or queue it behind the current job if it moves the
+// robot (command_queue.h). STOP clears the queue itself.
+ReplyResult dispatchCommand(const RobotCommand &command, Reply &reply) {
+  if (commandPriority(command.id) == PRIORITY_QUEUED && (robotBusy() || !jobQueue.empty())) {
+    return queueCommand(command, reply);
+  }
+  return executeCommand(command, reply);
+}
+
+ReplyResult executeCommand(const RobotCommand &command, Reply &reply) {
+  switch (command.id) {
+    case CMD_GO_TO_TABLE:
+      if (!moveArgumentsValid(command)) {
+        return RESULT_INVALID_ARGUMENT;
+      }
+      goToTable(command.args[0], reply);
+      return RESULT_OK;
+      
+    case CMD_RETURN_HOME:
+      returnHome(reply);
+      return RESULT_OK;
+      
+    case CMD_STOP:
+      stopRobot(reply);
+      return RESULT_OK;
+      
+    case CMD_STATUS:
+      sendStatus(reply);
+      return RESULT_OK;
+      
+    case CMD_HELLO:
+      sendHello(reply);
+      return RESULT_OK;
+      
+    case CMD_TUNE:
+      tuneLineTracker(command, reply);
+      return RESULT_OK;
+      
+    case CMD_CALIBRATE:
+      startCalibration(reply);
+      return RESULT_OK;
+      
+    case CMD_SET_MARKER:
+      return setMarker(command, reply);
+      
+    case CMD_DELIVER:
+      return startDelivery(command, reply);
+      
+    case CMD_QUEUE:
+      sendQueue(reply);
+      return RESULT_OK;
+      
+    case CMD_CLEAR:
+      clearQueue(reply);
+      return RESULT_OK;
+      
+    case CMD_CURVE_SPEED:
+      return setCurveSpeed(command, reply);
+      
+    case CMD_METRICS:
+      if (!Firmware::metrics) {
+        return RESULT_UNKNOWN_COMMAND;
+      }
+      return sendMetrics(command, reply);
+      
+    case CMD_SUBSCRIBE:
+      if (!Firmware::telemetry) {
+        return RESULT_UNKNOWN_COMMAND;
+      }
+      return subscribeTelemetry(command, reply);
+      
+    default:
+      return RESULT_UNKNOWN_COMMAND;
   }
-  else if (command.indexOf("status") >= 0) {
-    cmd = "status";
+}
+
+// Checked before queueing, so a bad command is refused straight away
+bool moveArgumentsValid(const RobotCommand &command) {
+  switch (command.id) {
+    case CMD_GO_TO_TABLE:
+      return command.args[0] >= 1 && command.args[0] <= 5;
+    case CMD_DELIVER:
+      return DeliveryPlanner::validTables(command.args, command.argCount);
+    default:
+      return true;
   }
-  // Support simple text commands
-  else if (command.startsWith("GO")) {
-    cmd = "go_to_table";
-    tableNumber = command.substring(2).toInt();
+}
+
+// A job is under way: travelling, calibrating or part-way through a
+// delivery run
+bool robotBusy() {
+  return currentState == GOING_TO_TABLE || currentState == RETURNING_HOME ||
+         currentState == CALIBRATING || delivery.active();
+}
+
+// Idle, or done waiting at the table just reached
+bool readyForNextJob() {
+  if (robotBusy()) {
+    return false;
   }
-  else if (command.equals("HOME")) {
-    cmd = "return_home";
+  return currentState != AT_TABLE || millis() - dwellStartTime >= stopDwellTime;
+}
+
+ReplyResult queueCommand(const RobotCommand &command, Reply &reply) {
+  if (!moveArgumentsValid(command)) {
+    return RESULT_INVALID_ARGUMENT;
   }
-  else if (command.equals("STOP")) {
-    cmd = "stop";
+  if (!jobQueue.push(command)) {
+    return RESULT_QUEUE_FULL;
   }
-  else if (command.equals("STATUS")) {
-    cmd = "status";
+  
+  Serial.print(F("Queued "));
+  Serial.println(commandName(command.id));
+  
+  if (binaryReplies()) {
+    addEvent(reply, EVENT_QUEUED, jobQueue.depth());
+    return RESULT_OK;
   }
+  reply.field(F("status"), F("queued"));
+  reply.field(F("queue"), jobQueue.depth());
+  return RESULT_OK;
+}
+
+// Start the oldest queued command; its reply goes out like an event
+void runNextJob() {
+  RobotCommand command;
+  jobQueue.pop(command);
   
-  // Execute command
-  if (cmd.equals("go_to_table")) {
-    if (tableNumber >= 1 && tableNumber <= 5) {
-      goToTable(tableNumber);
-    } else {
-      sendResponse("ERROR: Invalid table number (1-5)");
+  Reply reply;
+  if (binaryReplies()) {
+    executeCommand(command, reply);
+  } else {
+    reply.beginObject();
+    executeCommand(command, reply);
+    reply.field(F("command"), commandName(command.id));
+    reply.field(F("queue"), jobQueue.depth());
+    reply.endObject();
+  }
+  sendReply(reply);
+}
+
+// QUEUE: the waiting commands in order, with their (first) table
+void sendQueue(Reply &reply) {
+  unsigned char depth = jobQueue.depth();
+  if (binaryReplies()) {
+    FrameBuilder frame;
+    frame.begin(REPLY_QUEUE);
+    frame.add(depth);
+    for (unsigned char i = 0; i < depth; i++) {
+      frame.add(jobQueue.at(i).id);
+      frame.add(jobQueue.at(i).args[0]);
     }
+    reply.frame(frame);
+    return;
   }
-  else if (cmd.equals("return_home")) {
-    returnHome();
+  const __FlashStringHelper *commands[kCommandQueueSize];
+  unsigned int tables[kCommandQueueSize];
+  for (unsigned char i = 0; i < depth; i++) {
+    commands[i] = commandName(jobQueue.at(i).id);
+    tables[i] = jobQueue.at(i).args[0];
   }
-  else if (cmd.equals("stop")) {
-    stopRobot();
+  reply.field(F("status"), F("queue"));
+  reply.field(F("depth"), depth);
+  reply.field(F("commands"), commands, depth);
+  reply.field(F("tables"), tables, depth);
+}
+
+// CLEAR: drop the waiting commands; the current job carries on
+void clearQueue(Reply &reply) {
+  unsigned char removed = jobQueue.clear();
+  if (binaryReplies()) {
+    addEvent(reply, EVENT_QUEUED, 0);
+    return;
   }
-  else if (cmd.equals("status")) {
-    sendStatus();
+  reply.field(F("status"), F("cleared"));
+  reply.field(F("removed"), removed);
+}
+
+// Error text for RESULT_INVALID_ARGUMENT
+const __FlashStringHelper *invalidArgumentText(CommandId id) {
+  switch (id) {
+    case CMD_SET_MARKER: return F("Invalid stop (0-5) or layout node");
+    case CMD_DELIVER: return F("Invalid tables (1-5, up to 5, no repeats)");
+    case CMD_CURVE_SPEED: return F("Invalid speeds (5 values, 10-100%)");
+    case CMD_METRICS: return F("Invalid section (0-9)");
+    case CMD_SUBSCRIBE: return F("Invalid period (0 or 100-60000 ms)");
+    default: return F("Invalid table number (1-5)");
   }
-  else {
-    sendResponse("ERROR: Unknown command");
+}
+
+void goToTable(int tableNumber, Reply &reply) {
+  delivery.clear();
+  headForTable(tableNumber);
+  
+  // Status update
+  if (binaryReplies()) {
+    addEvent(reply, EVENT_MOVING, tableNumber);
+    return;
   }
+  reply.field(F("status"), F("moving"));
+  reply.field(F("target_table"), tableNumber);
+  reply.field(F("current_position"), F("en_route"));
+}
+
+void returnHome(Reply &reply) {
+  delivery.clear();
+  headHome();
   
-  // Send acknowledgment
-  bluetooth.print("{\"status\":\"received\",\"command\":\"");
-  bluetooth.print(cmd);
-  bluetooth.println("\"}");
+  // Status update
+  if (binaryReplies()) {
+    addEvent(reply, EVENT_RETURNING, 0);
+    return;
+  }
+  reply.field(F("status"), F("returning"));
+  reply.field(F("target"), F("home"));
 }
 
-void goToTable(int tableNumber) {
+// Set off for a table or home from wherever the robot is
+void headForTable(int tableNumber) {
   targetTable = tableNumber;
   currentState = GOING_TO_TABLE;
   isAtHome = false;
-  journeyStartTime = millis();
+  startJourney(markerMap.nodeFor(tableNumber));
   
-  Serial.print("Going to table ");
+  Serial.print(F("Going to table "));
   Serial.println(tableNumber);
-  
-  // Send status update
-  bluetooth.print("{\"status\":\"moving\",\"target_table\":");
-  bluetooth.print(tableNumber);
-  bluetooth.println(",\"current_position\":\"en_route\"}");
 }
 
-void returnHome() {
+void headHome() {
   currentState = RETURNING_HOME;
   targetTable = 0;
-  journeyStartTime = millis();
+  startJourney(markerMap.nodeFor(0));
   
-  Serial.println("Returning home");
+  Serial.println(F("Returning home"));
+}
+
+// DELIVER: visit every table on the tray in the cheapest order for the
+// layout, waiting at each, then return home
+ReplyResult startDelivery(const RobotCommand &command, Reply &reply) {
+  if (!delivery.begin(command.args, command.argCount)) {
+    return RESULT_INVALID_ARGUMENT;
+  }
+  long runMm = delivery.optimize(currentPosition(), deliveryLegMm);
+  if (runMm < 0) {
+    delivery.clear();
+    return RESULT_INVALID_ARGUMENT;
+  }
+  headForTable(delivery.nextStop());
+  
+  Serial.print(F("Delivery run "));
+  Serial.print(runMm);
+  Serial.println(F(" mm"));
+  
+  if (binaryReplies()) {
+    addEvent(reply, EVENT_MOVING, targetTable);
+    return RESULT_OK;
+  }
+  unsigned int tables[kMaxDeliveryStops];
+  for (unsigned char i = 0; i < delivery.stopCount(); i++) {
+    tables[i] = delivery.stop(i);
+  }
+  reply.field(F("status"), F("delivering"));
+  reply.field(F("tables"), tables, delivery.stopCount());
+  reply.field(F("run_mm"), runMm);
+  reply.field(F("target_table"), targetTable);
+  return RESULT_OK;
+}
+
+// Planner cost of one delivery leg (stop 0 = home), moving the position on
+// to where the robot would arrive; -1 if the stop cannot be reached
+long deliveryLegMm(TrackPosition &position, unsigned char stop) {
+  RoutePlan plan{};
+  if (!planLayoutRoute(position, markerMap.nodeFor(stop), plan)) {
+    return -1;
+  }
+  position = stationPosition(plan.to);
+  return plan.costMm;
+}
+
+// Dwell over: report the departure and head for the next stop, or home
+// after the last one
+void leaveDeliveryStop() {
+  int table = targetTable;
+  delivery.advance();
+  if (delivery.active()) {
+    headForTable(delivery.nextStop());
+  } else {
+    headHome();
+  }
   
-  // Send status update
-  bluetooth.println("{\"status\":\"returning\",\"target\":\"home\"}");
+  Reply reply;
+  if (binaryReplies()) {
+    addEvent(reply, EVENT_DEPARTED, table);
+    addEvent(reply, delivery.active() ? EVENT_MOVING : EVENT_RETURNING, targetTable);
+  } else {
+    reply.beginObject();
+    reply.field(F("status"), F("departed"));
+    reply.field(F("table_number"), table);
+    reply.field(F("next_table"), targetTable);
+    reply.endObject();
+  }
+  sendReply(reply);
 }
 
-void stopRobot() {
+// STOP preempts everything: the current job, the rest of a delivery run
+// and every queued command
+void stopRobot(Reply &reply) {
+  unsigned char cleared = jobQueue.clear();
+  delivery.clear();
   currentState = IDLE;
   stopMotors();
   
-  Serial.println("Robot stopped");
+  Serial.println(F("Robot stopped"));
   
-  bluetooth.println("{\"status\":\"stopped\"}");
+  if (binaryReplies()) {
+    addEvent(reply, EVENT_STOPPED, currentTable);
+    return;
+  }
+  reply.field(F("status"), F("stopped"));
+  reply.field(F("cleared"), cleared);
 }
 
 void followLine() {
-  // Read analog sensor values
-  int leftVal = analogRead(leftSensor);
-  int centerVal = analogRead(centerSensor);
-  int rightVal = analogRead(rightSensor);
-  
-  // Convert to digital values (adjust threshold as needed)
-  int threshold = 512; // Middle value for 10-bit ADC
-  bool leftDetected = leftVal < threshold;
-  bool centerDetected = centerVal < threshold;
-  bool rightDetected = rightVal < threshold;
-  
-  // Line following logic
-  if (centerDetected) {
-    // On line - go straight
-    moveForward();
-  }
-  else if (leftDetected) {
-    // Line is to the left - turn left
-    turnLeft();
-  }
-  else if (rightDetected) {
-    // Line is to the right - turn right
-    turnRight();
-  }
-  else {
-    // No line detected - stop
+  // Latest complete sensor round; nothing to do until a new one arrives
+  if (!lineSensors.snapshot(lineSample)) {
+    return;
+  }
+  
+  // Per-sensor normalization to darkness (0 = floor, 1000 = line)
+  int darkness[kLineSensorCount];
+  sensorCalibration.normalize(lineSample.value, darkness);
+  
+  if (turningAround) {
+    turnAround(darkness);
+    return;
+  }
+  
+  // Cross-line markers identify the stops and junctions
+  if (markerDetector.update(darkness, odometry.distanceMm())) {
+    checkMarkerArrival();
+    if (currentState != GOING_TO_TABLE && currentState != RETURNING_HOME) {
+      return;
+    }
+  }
+  if (odometry.distanceMm() >= branchEndMm) {
+    lineTracker.setBranch(0);
+  }
+  
+  // Forward speed from the profile, slower in curves and braking as the
+  // stop comes up
+  motionProfile.update(millis(), curveSpeed.scale(motionProfile.speedFor(lineTracker.speed())),
+                       remainingJourneyMm());
+  lineTracker.setDriveSpeed(motionProfile.pwm());
+  
+  // Weighted line position -> PID -> differential wheel speeds
+  if (lineTracker.update(darkness)) {
+    lineLastSeenTime = millis();
+  }
+  curveSpeed.update(lineTracker.position());
+  
+  // Line lost for too long - stop rather than wander off, and pull away
+  // gently if it comes back. Still nothing after a few seconds and the
+  // journey is given up, so the app hears about it.
+  if (millis() - lineLastSeenTime > lineLostFailTime) {
+    journeyFailed(F("line_lost"));
+    return;
+  }
+  if (millis() - lineLastSeenTime > lineLostTimeout) {
     stopMotors();
+    motionProfile.start(millis());
+    return;
   }
+  setMotorSpeeds(lineTracker.leftOutput(), lineTracker.rightOutput());
 }
 
-void checkTableArrival() {
-  if (targetTable > 0 && targetTable <= 5) {
-    unsigned long travelTime = millis() - journeyStartTime;
-    
-    if (travelTime >= tableDistances[targetTable]) {
-      arrivedAtTable();
+// Spin over the line in place, recording each sensor's min/max
+void startCalibration(Reply &reply) {
+  delivery.clear();
+  currentState = CALIBRATING;
+  calibrationStartTime = millis();
+  sensorCalibration.beginSweep();
+  
+  Serial.println(F("Calibrating sensors"));
+  
+  if (binaryReplies()) {
+    addEvent(reply, EVENT_CALIBRATING, 0);
+    return;
+  }
+  reply.field(F("status"), F("calibrating"));
+}
+
+void calibrationSweep() {
+  unsigned long elapsed = millis() - calibrationStartTime;
+  if (elapsed >= calibrationTime) {
+    finishCalibration();
+    return;
+  }
+  
+  // Left, right past the start, then back to where we began
+  if (elapsed < calibrationTime / 4 || elapsed >= calibrationTime * 3 / 4) {
+    setMotorSpeeds(-calibrationSpeed, calibrationSpeed);
+  } else {
+    setMotorSpeeds(calibrationSpeed, -calibrationSpeed);
+  }
+  
+  if (lineSensors.snapshot(lineSample)) {
+    sensorCalibration.addSample(lineSample.value);
+  }
+}
+
+void finishCalibration() {
+  currentState = IDLE;
+  stopMotors();
+  
+  // Keep the old calibration if a sensor never saw both floor and line
+  bool ok = sensorCalibration.finishSweep();
+  if (ok) {
+    saveCalibration();
+  }
+  
+  Serial.println(ok ? F("Calibration saved") : F("Calibration failed"));
+  
+  unsigned int minimum[kCalibrationSensors];
+  unsigned int maximum[kCalibrationSensors];
+  for (unsigned char i = 0; i < kCalibrationSensors; i++) {
+    minimum[i] = sensorCalibration.sweepMinimum(i);
+    maximum[i] = sensorCalibration.sweepMaximum(i);
+  }
+  
+  Reply reply;
+  if (binaryReplies()) {
+    addEvent(reply, EVENT_CALIBRATED, ok ? 1 : 0);
+  } else {
+    reply.beginObject();
+    reply.field(F("status"), ok ? F("calibrated") : F("calibration_failed"));
+    reply.field(F("min"), minimum, kCalibrationSensors);
+    reply.field(F("max"), maximum, kCalibrationSensors);
+    reply.endObject();
+  }
+  sendReply(reply);
+}
+
+void loadCalibration() {
+  StoredCalibration image;
+  EEPROM.get(calibrationAddress, image);
+  if (sensorCalibration.load(image)) {
+    Serial.println(F("Sensor calibration loaded"));
+  } else {
+    Serial.println(F("No sensor calibration, send CALIBRATE"));
+  }
+}
+
+void saveCalibration() {
+  // put() only rewrites bytes that changed, sparing EEPROM wear
+  EEPROM.put(calibrationAddress, sensorCalibration.stored());
+}
+
+#ifdef __AVR__
+// Hand each finished conversion to the sampler, which starts the next one
+ISR(ADC_vect) {
+  lineSensors.onConversionComplete();
+}
+#endif
+
+// Plan the shortest way from the current position to a layout node, in
+// either direction, and set off (turning round first if that is shorter).
+// The layout is checked at build time (layoutRoutable in track_layout.h),
+// so every node can be reached and planning cannot fail here; MARKER only
+// accepts nodes of the layout.
+void startJourney(unsigned char toNode) {
+  TrackPosition position = currentPosition();
+  planLayoutRoute(position, toNode, journeyPlan);
+  odometry.reset(millis());
+  
+  // Where the robot is once facing the route's way, measured from here on
+  TrackPosition start = layoutRouteStart(position, journeyPlan);
+  setPosition(start.behind, start.ahead, -start.offsetMm);
+  atStation = false;
+  
+  turningAround = journeyPlan.turnAround;
+  if (turningAround) {
+    turnLeftLine = false;
+    turnStarted = false;
+    Serial.println(F("Turning round"));
+    return;
+  }
+  beginRoute();
+}
+
+// Fresh controller state and marker count for the planned route
+void beginRoute() {
+  lineTracker.reset();
+  motionProfile.start(millis());
+  curveSpeed.reset();
+  markerDetector.reset(odometry.distanceMm());
+  lineLastSeenTime = millis();
+  takeBranch(journey.start(journeyPlan.route, journeyPlan.approachMm,
+                           journeyPlan.approachMarker));
+}
+
+void turnAround(const int darkness[kLineSensorCount]) {
+  if (!turnStarted) {
+    turnStarted = true;
+    turnStartTime = millis();
+  }
+  unsigned long elapsed = millis() - turnStartTime;
+  if (darkness[1] < turnLineOff) {
+    turnLeftLine = true;
+  }
+  if (turnLeftLine && elapsed >= turnAroundMinTime && darkness[1] > turnLineOn) {
+    turningAround = false;
+    beginRoute();
+    return;
+  }
+  if (elapsed > turnAroundTimeout) {
+    journeyFailed(F("turn_failed"));
+    return;
+  }
+  setMotorSpeeds(turnAroundSpeed, -turnAroundSpeed);
+}
+
+// Distance travelled past the current station, 0 while stopped at it
+long positionOffsetMm() {
+  return atStation ? 0 : odometry.distanceMm() - stationDistanceMm;
+}
+
+TrackPosition currentPosition() {
+  if (atStation) {
+    return stationPosition(currentStation);
+  }
+  TrackPosition position = {currentStation, nextStation, positionOffsetMm()};
+  return position;
+}
+
+// On the way from `station` (passed at odometry distance `distanceMm`) to
+// `ahead`
+void setPosition(unsigned char station, unsigned char ahead, long distanceMm) {
+  currentStation = station;
+  nextStation = ahead;
+  segmentMm = layoutDistanceMm(station, ahead);
+  stationDistanceMm = distanceMm;
+}
+
+// Passed a station of the current route: on to the next one
+void passStation(unsigned char station, long distanceMm) {
+  setPosition(station, layoutNextStation(station, journeyPlan.to), distanceMm);
+}
+
+// Favour one side of the line for a short way, so the tracker follows the
+// chosen branch where the line splits
+void takeBranch(TurnDirection turn) {
+  lineTracker.setBranch(turn == TURN_LEFT ? -1 : (turn == TURN_RIGHT ? 1 : 0));
+  branchEndMm = odometry.distanceMm() + branchDistanceMm;
+}
+
+// TUNE kp ki kd speed: any parameter not given keeps its current value, so
+// TUNE on its own just reports the settings
+void tuneLineTracker(const RobotCommand &command, Reply &reply) {
+  int gains[3] = {
+    lineTracker.proportionalGain(),
+    lineTracker.integralGain(),
+    lineTracker.derivativeGain()
+  };
+  for (unsigned char i = 0; i < 3; i++) {
+    if (command.argMask & (1 << i)) {
+      gains[i] = command.args[i];
     }
   }
+  if (command.argMask & 0x07) {
+    lineTracker.setGains(gains[0], gains[1], gains[2]);
+  }
+  if (command.argMask & 0x08) {
+    lineTracker.setBaseSpeed(command.args[3]);
+  }
+  
+  Serial.print(F("PID tuned: "));
+  Serial.print(lineTracker.proportionalGain());
+  Serial.print(F(" "));
+  Serial.print(lineTracker.integralGain());
+  Serial.print(F(" "));
+  Serial.print(lineTracker.derivativeGain());
+  Serial.print(F(" speed "));
+  Serial.println(lineTracker.speed());
+  
+  if (binaryReplies()) {
+    return;
+  }
+  reply.field(F("status"), F("tuned"));
+  reply.field(F("kp"), lineTracker.proportionalGain());
+  reply.field(F("ki"), lineTracker.integralGain());
+  reply.field(F("kd"), lineTracker.derivativeGain());
+  reply.field(F("speed"), lineTracker.speed());
+}
+
+// CURVE s0 s1 s2 s3 s4: cruise speed (%) at curvature 0, 250, 500, 750 and
+// 1000; CURVE on its own just reports the table
+ReplyResult setCurveSpeed(const RobotCommand &command, Reply &reply) {
+  if (command.argCount > 0 && !curveSpeed.setTable(command.args, command.argCount)) {
+    return RESULT_INVALID_ARGUMENT;
+  }
+  
+  unsigned int speeds[kCurvePoints];
+  Serial.print(F("Curve speeds:"));
+  for (unsigned char i = 0; i < kCurvePoints; i++) {
+    speeds[i] = curveSpeed.tablePercent(i);
+    Serial.print(F(" "));
+    Serial.print(speeds[i]);
+  }
+  Serial.println();
+  
+  if (binaryReplies()) {
+    return RESULT_OK;
+  }
+  reply.field(F("status"), F("curve_speed"));
+  reply.field(F("speeds"), speeds, kCurvePoints);
+  return RESULT_OK;
+}
+
+// Unmarked destinations (home by default) arrive by distance once every
+// marker on the route is behind; marked ones must be seen before the
+// search limit
+void checkJourneyArrival() {
+  // Unmarked stations on the way (home on a loop) are passed by distance
+  if (nextStation != journeyPlan.to && !layoutStationMarked(nextStation) &&
+      positionOffsetMm() >= segmentMm) {
+    passStation(nextStation, stationDistanceMm + segmentMm);
+  }
+  if (journey.arrived(odometry.distanceMm())) {
+    arrivedAtStop();
+  }
+  else if (odometry.distanceMm() > journey.lengthMm() * markerSearchPercent / 100) {
+    journeyFailed(F("marker_missed"));
+  }
 }
 
-void checkHomeArrival() {
-  unsigned long travelTime = millis() - journeyStartTime;
+// A marker was just confirmed under the sensors: a junction (take the
+// route's branch) or the destination
+void checkMarkerArrival() {
+  takeBranch(journey.passMarker());
+  passStation(layoutMarkerStation(journeyPlan, journey.markersCrossed()), odometry.distanceMm());
   
-  // Time to return home
-  if (travelTime >= 10000) { // 10 seconds
+  Serial.print(F("Marker "));
+  Serial.print(journey.markersCrossed());
+  Serial.print(F("/"));
+  Serial.println(journey.markersTotal());
+  
+  if (journey.arrived(odometry.distanceMm())) {
+    arrivedAtStop();
+  }
+}
+
+void arrivedAtStop() {
+  setPosition(journeyPlan.to, journeyPlan.to, odometry.distanceMm());
+  atStation = true;
+  
+  if (currentState == GOING_TO_TABLE) {
+    arrivedAtTable();
+  } else {
     arrivedAtHome();
   }
 }
 
+// Give up on the journey (marker_missed, turn_failed, line_lost). The position stays
+// at the last station passed, so the next journey starts from there; the
+// queue is dropped rather than set off from somewhere unexpected.
+void journeyFailed(const __FlashStringHelper *error) {
+  jobQueue.clear();
+  delivery.clear();
+  currentState = IDLE;
+  stopMotors();
+  
+  Serial.print(F("Stopping: "));
+  Serial.println(error);
+  
+  Reply reply;
+  if (binaryReplies()) {
+    addEvent(reply, EVENT_STOPPED, currentTable);
+  } else {
+    reply.beginObject();
+    reply.field(F("status"), F("stopped"));
+    reply.field(F("error"), error);
+    reply.field(F("markers"), markerDetector.count());
+    reply.endObject();
+  }
+  sendReply(reply);
+}
+
+// MARKER stop node: stop 0 is home, 1-5 the tables. MARKER on its own
+// reports the map.
+ReplyResult setMarker(const RobotCommand &command, Reply &reply) {
+  if (command.argCount > 0) {
+    if (command.argCount < 2 ||
+        !markerMap.set(command.args[0], command.args[1], kLayoutNodes)) {
+      return RESULT_INVALID_ARGUMENT;
+    }
+    EEPROM.put(markerMapAddress, markerMap.stored());
+  }
+  
+  if (binaryReplies()) {
+    return RESULT_OK;
+  }
+  unsigned int markers[kMarkerMapSize];
+  for (unsigned char i = 0; i < kMarkerMapSize; i++) {
+    markers[i] = markerMap.nodeFor(i);
+  }
+  reply.field(F("status"), F("marker_map"));
+  reply.field(F("markers"), markers, kMarkerMapSize);
+  return RESULT_OK;
+}
+
+void loadMarkerMap() {
+  StoredMarkerMap image;
+  EEPROM.get(markerMapAddress, image);
+  if (!markerMap.load(image, kLayoutNodes)) {
+    Serial.println(F("Default marker map (table N at node N)"));
+  }
+}
+
+// Distance left to the stop, going by the route length (a marked stop may
+// turn up a little early or late; the robot creeps until it does)
+long remainingJourneyMm() {
+  long remaining = journey.lengthMm() - odometry.distanceMm();
+  return remaining > 0 ? remaining : 0;
+}
+
+// Length of the current journey in mm, or 0 when not travelling
+long journeyDistanceMm() {
+  if (currentState == GOING_TO_TABLE || currentState == RETURNING_HOME) {
+    return journey.lengthMm();
+  }
+  return 0;
+}
+
+void leftEncoderISR() {
+  odometry.onLeftTick();
+}
+
+void rightEncoderISR() {
+  odometry.onRightTick();
+}
+
 void arrivedAtTable() {
   currentState = AT_TABLE;
   currentTable = targetTable;
+  dwellStartTime = millis();
   stopMotors();
   
-  Serial.print("Arrived at table ");
+  Serial.print(F("Arrived at table "));
   Serial.println(targetTable);
   
   // Send arrival notification
-  bluetooth.print("{\"status\":\"arrived\",\"table_number\":");
-  bluetooth.print(targetTable);
-  bluetooth.print(",\"current_position\":\"table_");
-  bluetooth.print(targetTable);
-  bluetooth.println("\"}");
+  Reply reply;
+  if (binaryReplies()) {
+    addEvent(reply, EVENT_ARRIVED, targetTable);
+  } else {
+    reply.beginObject();
+    reply.field(F("status"), F("arrived"));
+    reply.field(F("table_number"), targetTable);
+    reply.field(F("current_position"), F("table_"), targetTable);
+    if (delivery.active()) {
+      reply.field(F("stop"), delivery.stopIndex() + 1);
+      reply.field(F("stops"), delivery.stopCount());
+    }
+    reply.endObject();
+  }
+  sendReply(reply);
 }
 
 void arrivedAtHome() {
@@ -281,41 +1251,280 @@ void arrivedAtHome() {
   currentTable = 0;
   stopMotors();
   
-  Serial.println("Arrived at home");
+  Serial.println(F("Arrived at home"));
   
   // Send home arrival notification
-  bluetooth.println("{\"status\":\"home\",\"current_position\":\"home\"}");
+  Reply reply;
+  if (binaryReplies()) {
+    addEvent(reply, EVENT_HOME, 0);
+  } else {
+    reply.beginObject();
+    reply.field(F("status"), F("home"));
+    reply.field(F("current_position"), F("home"));
+    reply.endObject();
+  }
+  sendReply(reply);
 }
 
-void sendStatus() {
-  String state = getStateString();
+// STATUS: where the robot is and how far it has to go, kept short because
+// the loop stalls while it is written. Link counters and the robot's
+// estimates are in METRICS.
+void sendStatus(Reply &reply) {
+  const __FlashStringHelper *state = getStateString();
   
-  bluetooth.print("{\"state\":\"");
-  bluetooth.print(state);
-  bluetooth.print("\",\"current_table\":");
-  bluetooth.print(currentTable);
-  bluetooth.print(",\"target_table\":");
-  bluetooth.print(targetTable);
-  bluetooth.print(",\"is_at_home\":");
-  bluetooth.print(isAtHome ? "true" : "false");
-  bluetooth.println("}");
+  if (binaryReplies()) {
+    FrameBuilder frame;
+    frame.begin(REPLY_STATUS);
+    frame.add(currentState);
+    frame.add(currentTable);
+    frame.add(targetTable);
+    frame.add(isAtHome);
+    frame.add(journeyDistanceMm() ? odometry.progressPercent(journeyDistanceMm()) : 0);
+    frame.add(journeyDistanceMm() ? odometry.etaMillis(journeyDistanceMm()) : 0);
+    reply.frame(frame);
+  } else {
+    reply.field(F("state"), state);
+    reply.field(F("current_table"), currentTable);
+    reply.field(F("target_table"), targetTable);
+    reply.boolField(F("is_at_home"), isAtHome);
+    if (journeyDistanceMm() > 0) {
+      // eta_ms is -1 while the robot is not moving forward
+      reply.field(F("progress"), odometry.progressPercent(journeyDistanceMm()));
+      reply.field(F("eta_ms"), odometry.etaMillis(journeyDistanceMm()));
+    }
+  }
   
-  Serial.print("Status sent: ");
+  Serial.print(F("Status sent: "));
   Serial.println(state);
 }
 
-void sendResponse(String message) {
-  bluetooth.println(message);
-  Serial.println(message);
+// Protocol version and supported command formats
+void sendHello(Reply &reply) {
+  unsigned char caps = (Firmware::jsonCommands ? CAP_JSON : 0) |
+                       (Firmware::textCommands ? CAP_TEXT : 0) |
+                       (Firmware::binaryFrames ? CAP_BINARY : 0);
+  if (binaryReplies()) {
+    FrameBuilder frame;
+    frame.begin(REPLY_HELLO);
+    frame.add(kProtocolVersion);
+    frame.add(caps);
+    reply.frame(frame);
+    return;
+  }
+  reply.field(F("status"), F("hello"));
+  reply.field(F("protocol"), kProtocolVersion);
+  reply.field(F("caps"), caps);
+}
+
+// Sections with timings: the summary, the loop, the tasks and the replies
+unsigned char metricsTimingSections() {
+  return kMetricsFirstTask + scheduler.size() + 1;
+}
+
+unsigned char metricsLinkSection() {
+  return metricsTimingSections();
+}
+
+unsigned char metricsRobotSection() {
+  return metricsTimingSections() + 1;
+}
+
+unsigned char metricsSections() {
+  return metricsTimingSections() + 2;
+}
+
+const TaskStats &metricsStats(unsigned char section) {
+  if (section == kMetricsLoop) {
+    return scheduler.passStats();
+  }
+  if (section < kMetricsFirstTask + scheduler.size()) {
+    return scheduler.task(section - kMetricsFirstTask).cost;
+  }
+  return replyStats;
+}
+
+const char *metricsName(unsigned char section) {
+  if (section == kMetricsLoop) {
+    return "loop";
+  }
+  if (section < kMetricsFirstTask + scheduler.size()) {
+    return scheduler.task(section - kMetricsFirstTask).name;
+  }
+  return "reply";
+}
+
+unsigned long metricsMisses(unsigned char section) {
+  if (section == kMetricsLoop) {
+    return scheduler.totalDeadlineMisses();
+  }
+  if (section < kMetricsFirstTask + scheduler.size()) {
+    return scheduler.task(section - kMetricsFirstTask).deadlineMisses;
+  }
+  return 0;
+}
+
+// METRICS [section] [reset]: loop period, task and reply timings in
+// microseconds. The summary gives min/mean/max per section, a section its
+// count, deadline misses and histogram (timing_stats.h). After the timings
+// come two sections of counters: the links (receive losses, reply writes)
+// and the robot's own estimates (line, odometry, markers). A non-zero
+// reset clears every timing statistic once the reply is built.
+ReplyResult sendMetrics(const RobotCommand &command, Reply &reply) {
+  int section = (command.argMask & 1) ? command.args[0] : 0;
+  bool reset = (command.argMask & 2) && command.args[1] != 0;
+  if (section < 0 || section >= metricsSections()) {
+    return RESULT_INVALID_ARGUMENT;
+  }
+  
+  if (binaryReplies()) {
+    // Summary: 0, then mean and max per section; a section: its number,
+    // count, min, mean, max, misses and the histogram buckets; a counter
+    // section: its number and the counters in JSON order
+    FrameBuilder frame;
+    frame.begin(REPLY_METRICS);
+    frame.add(section);
+    if (section == 0) {
+      for (unsigned char i = kMetricsLoop; i < metricsTimingSections(); i++) {
+        frame.add(metricsStats(i).meanMicros());
+        frame.add(metricsStats(i).maxMicros());
+      }
+    } else if (section == metricsLinkSection()) {
+      frame.add(rxOverflows);
+      frame.add(bluetoothReader.tooLongCount());
+      frame.add(lastReplyMicros);
+      frame.add(replyTruncations);
+    } else if (section == metricsRobotSection()) {
+      frame.add(lineTracker.position());
+      frame.add(curveSpeed.curvature());
+      frame.add(sensorCalibration.isCalibrated());
+      frame.add(odometry.distanceMm());
+      frame.add(odometry.speedMmPerSecond());
+      frame.add(markerDetector.count());
+      frame.add(stationNode(currentStation));
+    } else {
+      const TaskStats &stats = metricsStats(section);
+      frame.add(stats.count());
+      frame.add(stats.minMicros());
+      frame.add(stats.meanMicros());
+      frame.add(stats.maxMicros());
+      frame.add(metricsMisses(section));
+      for (unsigned char i = 0; i < kTimingBuckets; i++) {
+        frame.add(stats.bucket(i));
+      }
+    }
+    reply.frame(frame);
+  } else {
+    reply.field(F("status"), F("metrics"));
+    if (section == 0) {
+      for (unsigned char i = kMetricsLoop; i < metricsTimingSections(); i++) {
+        const TaskStats &stats = metricsStats(i);
+        unsigned long summary[3] = {stats.minMicros(), stats.meanMicros(), stats.maxMicros()};
+        reply.field(metricsName(i), summary, 3);
+      }
+      reply.field(F("misses"), scheduler.totalDeadlineMisses());
+    } else if (section == metricsLinkSection()) {
+      reply.field(F("section"), F("link"));
+      reply.field(F("rx_overflows"), rxOverflows);
+      reply.field(F("rx_too_long"), bluetoothReader.tooLongCount());
+      reply.field(F("tx_us"), lastReplyMicros);
+      reply.field(F("tx_truncated"), replyTruncations);
+    } else if (section == metricsRobotSection()) {
+      reply.field(F("section"), F("robot"));
+      reply.field(F("line_position"), lineTracker.position());
+      reply.field(F("curvature"), curveSpeed.curvature());
+      reply.boolField(F("calibrated"), sensorCalibration.isCalibrated());
+      reply.field(F("distance_mm"), odometry.distanceMm());
+      reply.field(F("speed_mm_s"), odometry.speedMmPerSecond());
+      reply.field(F("markers"), markerDetector.count());
+      reply.field(F("node"), stationNode(currentStation));
+    } else {
+      const TaskStats &stats = metricsStats(section);
+      unsigned int buckets[kTimingBuckets];
+      for (unsigned char i = 0; i < kTimingBuckets; i++) {
+        buckets[i] = stats.bucket(i);
+      }
+      reply.field(F("section"), metricsName(section));
+      reply.field(F("count"), stats.count());
+      reply.field(F("min"), stats.minMicros());
+      reply.field(F("mean"), stats.meanMicros());
+      reply.field(F("max"), stats.maxMicros());
+      reply.field(F("misses"), metricsMisses(section));
+      reply.field(F("hist"), buckets, kTimingBuckets);
+    }
+    if (reset) {
+      reply.boolField(F("reset"), true);
+    }
+  }
+  
+  if (reset) {
+    scheduler.resetStats();
+    replyStats.reset();
+    Serial.println(F("Metrics reset"));
+  }
+  return RESULT_OK;
+}
+
+// SUBSCRIBE [period_ms]: stream telemetry every period_ms (default 200),
+// 0 stops. The first frame, a key frame, follows the reply.
+ReplyResult subscribeTelemetry(const RobotCommand &command, Reply &reply) {
+  long period = (command.argMask & 1) ? command.args[0] : kTelemetryDefaultPeriodMs;
+  if (!telemetry.subscribe(period, millis())) {
+    return RESULT_INVALID_ARGUMENT;
+  }
+  telemetryPasses = scheduler.passStats().count();
+  telemetryMicros = micros();
+  
+  Serial.print(F("Telemetry period: "));
+  Serial.println(telemetry.period());
+  
+  if (binaryReplies()) {
+    return RESULT_OK;
+  }
+  reply.field(F("status"), telemetry.active() ? F("subscribed") : F("unsubscribed"));
+  reply.field(F("period_ms"), telemetry.period());
+  reply.field(F("fields"), (int)kTelemetryFields);
+  return RESULT_OK;
+}
+
+void addEvent(Reply &reply, RobotEvent event, int table) {
+  FrameBuilder frame;
+  frame.begin(REPLY_EVENT);
+  frame.add(event);
+  frame.add(table);
+  reply.frame(frame);
 }
 
-String getStateString() {
+// Always false when binary frames are compiled out, so the frame replies
+// are too
+bool binaryReplies() {
+  return Firmware::binaryFrames && binaryLink;
+}
+
+// Write a finished reply to the Bluetooth link in one go, timing the write.
+// A truncated reply still goes out, complete JSON, and is counted.
+void sendReply(Reply &reply) {
+  if (reply.wasTruncated()) {
+    replyTruncations++;
+    Serial.println(F("Reply truncated"));
+  }
+  unsigned long start = micros();
+  if (Firmware::usbCommands && usbCommand) {
+    reply.sendTo(Serial);
+  } else {
+    reply.sendTo(bluetooth);
+  }
+  lastReplyMicros = micros() - start;
+  replyStats.add(lastReplyMicros);
+}
+
+const __FlashStringHelper *getStateString() {
   switch (currentState) {
-    case IDLE: return "idle";
-    case GOING_TO_TABLE: return "going_to_table";
-    case AT_TABLE: return "at_table";
-    case RETURNING_HOME: return "returning_home";
-    default: return "unknown";
+    case IDLE: return F("idle");
+    case GOING_TO_TABLE: return F("going_to_table");
+    case AT_TABLE: return F("at_table");
+    case RETURNING_HOME: return F("returning_home");
+    case CALIBRATING: return F("calibrating");
+    default: return F("unknown");
   }
 }
 
@@ -330,36 +1539,20 @@ void blinkLED() {
   }
 }
 
-// Motor control functions
-void moveForward() {
-  analogWrite(leftMotorPin1, motorSpeed);
-  analogWrite(leftMotorPin2, 0);
-  analogWrite(rightMotorPin1, motorSpeed);
-  analogWrite(rightMotorPin2, 0);
-}
-
-void moveBackward() {
-  analogWrite(leftMotorPin1, 0);
-  analogWrite(leftMotorPin2, motorSpeed);
-  analogWrite(rightMotorPin1, 0);
-  analogWrite(rightMotorPin2, motorSpeed);
-}
-
-void turnLeft() {
-  analogWrite(leftMotorPin1, 0);
-  analogWrite(leftMotorPin2, motorSpeed/2);
-  analogWrite(rightMotorPin1, motorSpeed);
-  analogWrite(rightMotorPin2, 0);
-}
-
-void turnRight() {
-  analogWrite(leftMotorPin1, motorSpeed);
-  analogWrite(leftMotorPin2, 0);
-  analogWrite(rightMotorPin1, 0);
-  analogWrite(rightMotorPin2, motorSpeed/2);
+// Signed PWM per motor: positive drives forward, negative reverses
+void setMotorSpeeds(int left, int right) {
+  odometry.setDirections(left, right);
+  leftMotorPwm = left;
+  rightMotorPwm = right;
+  analogWrite(leftMotorPin1, left > 0 ? left : 0);
+  analogWrite(leftMotorPin2, left < 0 ? -left : 0);
+  analogWrite(rightMotorPin1, right > 0 ? right : 0);
+  analogWrite(rightMotorPin2, right < 0 ? -right : 0);
 }
 
 void stopMotors() {
+  leftMotorPwm = 0;
+  rightMotorPwm = 0;
   analogWrite(leftMotorPin1, 0);
   analogWrite(leftMotorPin2, 0);
   analogWrite(rightMotorPin1, 0);
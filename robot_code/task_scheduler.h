@@ -0,0 +1,109 @@
+// Smart Waiter Robot - Cooperative Task Scheduler
+// Fixed-rate, micros()-based scheduler used by loop() instead of a blocking delay()
+
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+#include "timing_stats.h"
+
+// A periodic task. Only the first three fields are filled in by the sketch;
+// the rest is scheduler bookkeeping. Stats is TimingStats, or
+// NullTimingStats to leave the timing out.
+template <typename Stats>
+struct BasicTask {
+  const char *name;             // Short name for status/debug output
+  void (*run)();                // Task body, must not block
+  unsigned long periodMicros;   // Desired period between runs
+  unsigned long nextRunMicros;  // Next due time
+  unsigned long deadlineMisses; // Whole periods skipped because we ran late
+  Stats cost;                   // Run time of each call, in microseconds
+};
+
+template <typename Stats>
+class BasicTaskScheduler {
+public:
+  typedef BasicTask<Stats> Task;
+
+  // With a clock (e.g. micros) each task's run time is measured too; the
+  // clock is read once per task that runs, and each reading doubles as the
+  // next task's start time.
+  BasicTaskScheduler(Task *tasks, unsigned char count, unsigned long (*clock)() = 0)
+      : tasks(tasks), count(count), clock(clock), lastPass(0) {}
+
+  // Schedule every task to run on the first call to run()
+  void begin(unsigned long now) {
+    for (unsigned char i = 0; i < count; i++) {
+      tasks[i].nextRunMicros = now;
+    }
+    resetStats();
+    lastPass = now;
+  }
+
+  // Run every task that is due, in table order. Tasks keep their phase
+  // (next = due + period) unless a whole period was missed, in which case
+  // the miss is counted and the task is re-synchronised to now so it does
+  // not run in a burst to catch up.
+  void run(unsigned long now) {
+    // The time between passes bounds how late any task can start
+    passes.add(now - lastPass);
+    lastPass = now;
+
+    unsigned long started = now;
+    for (unsigned char i = 0; i < count; i++) {
+      Task &task = tasks[i];
+      unsigned long late = now - task.nextRunMicros;
+      if ((long)late < 0) {
+        continue;
+      }
+
+      task.run();
+      if (clock) {
+        unsigned long finished = clock();
+        task.cost.add(finished - started);
+        started = finished;
+      }
+
+      if (late >= task.periodMicros) {
+        task.deadlineMisses += late / task.periodMicros;
+        task.nextRunMicros = now + task.periodMicros;
+      } else {
+        task.nextRunMicros += task.periodMicros;
+      }
+    }
+  }
+
+  unsigned long totalDeadlineMisses() const {
+    unsigned long total = 0;
+    for (unsigned char i = 0; i < count; i++) {
+      total += tasks[i].deadlineMisses;
+    }
+    return total;
+  }
+
+  // Time between calls to run(), i.e. the loop() period
+  const Stats &passStats() const { return passes; }
+
+  // Clear the timing statistics and deadline misses, keeping the schedule
+  void resetStats() {
+    for (unsigned char i = 0; i < count; i++) {
+      tasks[i].deadlineMisses = 0;
+      tasks[i].cost.reset();
+    }
+    passes.reset();
+  }
+
+  unsigned char size() const { return count; }
+  const Task &task(unsigned char index) const { return tasks[index]; }
+
+private:
+  Task *tasks;
+  unsigned char count;
+  unsigned long (*clock)();
+  unsigned long lastPass;
+  Stats passes;
+};
+
+typedef BasicTask<TimingStats> Task;
+typedef BasicTaskScheduler<TimingStats> TaskScheduler;
+
+#endif
@@ -0,0 +1,95 @@
+// Smart Waiter Robot - Telemetry Stream
+// After SUBSCRIBE the robot pushes a telemetry frame (REPLY_TELEMETRY) at a
+// fixed rate instead of waiting to be polled. Every frame carries the same
+// fields in the same order. A key frame holds the values themselves; the
+// frames in between hold the change since the previous frame, which is
+// usually small, so with varint encoding most fields take one byte.
+//
+// Frame values: header, then kTelemetryFields values.
+//   header = sequence * 2 + (1 if key frame). The sequence counts 0-31 and
+//   wraps; frame 0 and 16 of each cycle are key frames, as is the first
+//   frame after SUBSCRIBE. A receiver that sees a gap in the sequence
+//   ignores delta frames until the next key frame.
+//
+// A key frame is about 22 bytes on the wire and a delta frame about 16,
+// 17-23 ms at 9600 baud, during which SoftwareSerial holds the CPU. Hence
+// the 100 ms minimum period: faster, the 1 ms line task would be stalled
+// a fifth of the time or more.
+
+#ifndef TELEMETRY_STREAM_H
+#define TELEMETRY_STREAM_H
+
+#include "robot_protocol.h"
+
+enum TelemetryField {
+  TELEMETRY_SENSOR_LEFT,    // Raw ADC readings, 0-1023
+  TELEMETRY_SENSOR_CENTER,
+  TELEMETRY_SENSOR_RIGHT,
+  TELEMETRY_LINE_POSITION,  // Line error, -1000 (left) to 1000 (right)
+  TELEMETRY_LEFT_PWM,       // Signed motor PWM, -255 to 255
+  TELEMETRY_RIGHT_PWM,
+  TELEMETRY_STATE,          // RobotState
+  TELEMETRY_TARGET_TABLE,
+  TELEMETRY_PROGRESS,       // Journey progress in percent, 0 when not travelling
+  TELEMETRY_LOOP_US,        // Mean loop() period since the previous frame
+  kTelemetryFields
+};
+
+const unsigned char kTelemetrySequences = 32;
+const unsigned char kTelemetryKeyInterval = 16;
+const unsigned int kTelemetryDefaultPeriodMs = 200;
+const unsigned int kTelemetryMinPeriodMs = 100;
+const unsigned int kTelemetryMaxPeriodMs = 60000;
+
+class TelemetryStream {
+public:
+  constexpr TelemetryStream() : periodMs(0), lastSentMs(0), sequence(0), last() {}
+
+  // Start streaming every periodMs milliseconds, or stop with 0. Returns
+  // false (and changes nothing) if the period is out of range.
+  bool subscribe(long period, unsigned long nowMs) {
+    if (period != 0 && (period < (long)kTelemetryMinPeriodMs || period > (long)kTelemetryMaxPeriodMs)) {
+      return false;
+    }
+    periodMs = (unsigned int)period;
+    lastSentMs = nowMs - periodMs;
+    sequence = 0;
+    return true;
+  }
+
+  bool active() const { return periodMs != 0; }
+  unsigned long period() const { return periodMs; }
+
+  // True once per period. Keeps the phase unless a whole period was
+  // missed, so frames do not bunch up after a long reply.
+  bool due(unsigned long nowMs) {
+    if (periodMs == 0 || nowMs - lastSentMs < periodMs) {
+      return false;
+    }
+    lastSentMs += periodMs;
+    if (nowMs - lastSentMs >= periodMs) {
+      lastSentMs = nowMs;
+    }
+    return true;
+  }
+
+  // Build the next frame from a full set of field values
+  void encode(const long *values, FrameBuilder &frame) {
+    bool key = sequence % kTelemetryKeyInterval == 0;
+    frame.begin(REPLY_TELEMETRY);
+    frame.add(sequence * 2 + (key ? 1 : 0));
+    for (unsigned char i = 0; i < kTelemetryFields; i++) {
+      frame.add(key ? values[i] : values[i] - last[i]);
+      last[i] = values[i];
+    }
+    sequence = (sequence + 1) % kTelemetrySequences;
+  }
+
+private:
+  unsigned int periodMs;
+  unsigned long lastSentMs;
+  unsigned char sequence;
+  long last[kTelemetryFields];
+};
+
+#endif
@@ -0,0 +1,98 @@
+// Smart Waiter Robot - Timing Statistics
+// Min/max/mean and a small histogram of a duration in microseconds, cheap
+// enough to update on every loop() pass. Used by the task scheduler for the
+// loop period and each task's run time, and read with METRICS.
+//
+// Buckets grow by 4x: <8, <32, <128, <512, <2048, <8192, <32768 and
+// >=32768 us. Bucket counts are 16-bit; when one fills, all are halved, so
+// the histogram keeps its shape and count() keeps the true total. The mean
+// works the same way on 32 bits: when the running sum would overflow, it
+// and the number of samples in it are halved together. Everything stays
+// 32-bit arithmetic, which the AVR does in a few cycles.
+
+#ifndef TIMING_STATS_H
+#define TIMING_STATS_H
+
+const unsigned char kTimingBuckets = 8;
+
+class TimingStats {
+public:
+  TimingStats() { reset(); }
+
+  void reset() {
+    samples = 0;
+    minimum = 0;
+    maximum = 0;
+    total = 0;
+    totalSamples = 0;
+    for (unsigned char i = 0; i < kTimingBuckets; i++) {
+      buckets[i] = 0;
+    }
+  }
+
+  void add(unsigned long micros) {
+    if (samples == 0 || micros < minimum) {
+      minimum = micros;
+    }
+    if (micros > maximum) {
+      maximum = micros;
+    }
+    samples++;
+    while (total > 0xFFFFFFFFUL - micros) {
+      total >>= 1;
+      totalSamples >>= 1;
+    }
+    total += micros;
+    totalSamples++;
+
+    unsigned char bucket = 0;
+    while (bucket + 1 < kTimingBuckets && micros >= bucketLimit(bucket)) {
+      bucket++;
+    }
+    if (buckets[bucket] == 0xFFFF) {
+      for (unsigned char i = 0; i < kTimingBuckets; i++) {
+        buckets[i] >>= 1;
+      }
+    }
+    buckets[bucket]++;
+  }
+
+  unsigned long count() const { return samples; }
+  unsigned long minMicros() const { return minimum; }
+  unsigned long maxMicros() const { return maximum; }
+  unsigned long meanMicros() const {
+    return totalSamples ? total / totalSamples : 0;
+  }
+  unsigned int bucket(unsigned char index) const { return buckets[index]; }
+
+  // Upper bound (exclusive) of a bucket; the last one has none
+  static unsigned long bucketLimit(unsigned char index) { return 8UL << (2 * index); }
+
+private:
+  unsigned long samples;
+  unsigned long minimum;
+  unsigned long maximum;
+  unsigned long total;         // Sum of the last totalSamples durations
+  unsigned long totalSamples;
+  unsigned int buckets[kTimingBuckets];
+};
+
+// Stand-in with the same interface when timing is compiled out
+// (firmware_config.h): no storage, every reading is 0
+class NullTimingStats {
+public:
+  void reset() {}
+  void add(unsigned long) {}
+  unsigned long count() const { return 0; }
+  unsigned long minMicros() const { return 0; }
+  unsigned long maxMicros() const { return 0; }
+  unsigned long meanMicros() const { return 0; }
+  unsigned int bucket(unsigned char) const { return 0; }
+  static unsigned long bucketLimit(unsigned char index) { return TimingStats::bucketLimit(index); }
+};
+
+// TimingStats, or NullTimingStats if Enabled is false
+template <bool Enabled> struct TimingStatsFor { typedef TimingStats Type; };
+template <> struct TimingStatsFor<false> { typedef NullTimingStats Type; };
+
+#endif
@@ -0,0 +1,115 @@
+// Smart Waiter Robot - Track Layout
+// The restaurant's line layout as a route graph (route_graph.h). Edit the
+// node list and segments for a new site; every route between two nodes is
+// recomputed by the compiler and kept in flash.
+//
+// Node 0 is home and nodes 1-5 are tables 1-5 (the default stop map, see
+// MARKER); junctions follow. Every node except home has a cross-line marker.
+// Segments are listed in the usual direction of travel, with the turn onto
+// each from either end; one that cannot be followed backwards has
+// reverseTurn kOneWay.
+
+#ifndef TRACK_LAYOUT_H
+#define TRACK_LAYOUT_H
+
+#include "route_graph.h"
+
+// 1 = single loop past tables 1-5, 2 = two branches (second site)
+#ifndef TRACK_LAYOUT
+#define TRACK_LAYOUT 1
+#endif
+
+const unsigned char kHomeNode = 0;
+
+// Distance a turn on the spot is worth when choosing between heading on
+// and turning round
+const long kTurnAroundCostMm = 400;
+
+#if TRACK_LAYOUT == 1
+
+// home -> 1 -> 2 -> 3 -> 4 -> 5 -> home
+const unsigned char kLayoutNodes = 6;
+const unsigned long kLayoutMarkedNodes = 0x3E; // Tables 1-5
+
+constexpr TrackEdge layoutEdges[] = {
+  {0, 1, TURN_STRAIGHT, 1500, TURN_STRAIGHT},
+  {1, 2, TURN_STRAIGHT, 900,  TURN_STRAIGHT},
+  {2, 3, TURN_STRAIGHT, 1200, TURN_STRAIGHT},
+  {3, 4, TURN_STRAIGHT, 900,  TURN_STRAIGHT},
+  {4, 5, TURN_STRAIGHT, 900,  TURN_STRAIGHT},
+  {5, 0, TURN_STRAIGHT, 3000, TURN_STRAIGHT}
+};
+
+#elif TRACK_LAYOUT == 2
+
+// home -> junction 6 -+- left:  1 -> 2 ------+-> junction 7 -> home
+//                     +- right: 3 -> 4 -> 5 -+
+// Backwards into junction 7 the branches swap sides: table 2 is to the
+// right, table 5 to the left.
+const unsigned char kLayoutNodes = 8;
+const unsigned long kLayoutMarkedNodes = 0xFE; // Tables and junctions
+
+constexpr TrackEdge layoutEdges[] = {
+  {0, 6, TURN_STRAIGHT, 800,  TURN_STRAIGHT},
+  {6, 1, TURN_LEFT,     700,  TURN_STRAIGHT},
+  {1, 2, TURN_STRAIGHT, 900,  TURN_STRAIGHT},
+  {2, 7, TURN_STRAIGHT, 700,  TURN_RIGHT},
+  {6, 3, TURN_RIGHT,    900,  TURN_STRAIGHT},
+  {3, 4, TURN_STRAIGHT, 900,  TURN_STRAIGHT},
+  {4, 5, TURN_STRAIGHT, 900,  TURN_STRAIGHT},
+  {5, 7, TURN_STRAIGHT, 600,  TURN_LEFT},
+  {7, 0, TURN_STRAIGHT, 1500, TURN_STRAIGHT}
+};
+
+#else
+#error "Unknown TRACK_LAYOUT"
+#endif
+
+// Each node once per heading
+const unsigned char kLayoutStations = kLayoutNodes * 2;
+
+static_assert(kLayoutNodes <= 16, "layout: at most 16 nodes");
+static_assert(edgesValid(layoutEdges, kLayoutNodes),
+              "layoutEdges: node out of range, zero length or bad turn");
+
+constexpr StationEdges<sizeof(layoutEdges) / sizeof(layoutEdges[0])> layoutStationEdges =
+    stationEdges(layoutEdges);
+
+static_assert(layoutRoutable<kLayoutStations>(layoutStationEdges.edge,
+                                              stationMarks(kLayoutMarkedNodes)),
+              "layoutEdges: a node cannot be reached, a route is too long, or a "
+              "branch is taken at a junction without a marker");
+
+constexpr RouteTable<kLayoutStations> layoutRoutes PROGMEM =
+    makeRouteTable<kLayoutStations>(layoutStationEdges.edge, stationMarks(kLayoutMarkedNodes));
+
+// Best journey from where the robot is to a node
+inline bool planLayoutRoute(const TrackPosition &position, unsigned char node,
+                            RoutePlan &plan) {
+  return planRoute(layoutRoutes, position, node, kTurnAroundCostMm, plan);
+}
+
+// Where the robot is as it sets off on a planned journey
+inline TrackPosition layoutRouteStart(const TrackPosition &position, const RoutePlan &plan) {
+  return routeStart(layoutRoutes, position, plan);
+}
+
+// Next station after `station` on the way to `to`, and the distance to it
+inline unsigned char layoutNextStation(unsigned char station, unsigned char to) {
+  return routeNextStation(layoutRoutes, station, to);
+}
+
+inline long layoutDistanceMm(unsigned char from, unsigned char to) {
+  return routeLengthMm(layoutRoutes, from, to);
+}
+
+inline bool layoutStationMarked(unsigned char station) {
+  return nodeMarked(kLayoutMarkedNodes, stationNode(station));
+}
+
+// Where the robot is after crossing `count` markers on a planned route
+inline unsigned char layoutMarkerStation(const RoutePlan &plan, unsigned char count) {
+  return routeMarkerStation(layoutRoutes, plan.from, plan.to, count);
+}
+
+#endif
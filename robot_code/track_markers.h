@@ -0,0 +1,152 @@
+// Smart Waiter Robot - Track Marker Navigation
+// Tables are marked on the track by a cross line that darkens all three
+// sensors at once. MarkerDetector debounces those crossings and counts
+// them; MarkerMap says which layout node (track_layout.h) each table and
+// home is at, so the robot stops on a track feature instead of after a
+// guessed distance.
+
+#ifndef TRACK_MARKERS_H
+#define TRACK_MARKERS_H
+
+#include "robot_protocol.h"
+
+const unsigned char kMarkerSensors = 3;
+const unsigned char kMarkerMapSize = 6; // Home (0) and tables 1-5
+const unsigned char kMarkerMapMagic = 0x3A;
+const unsigned char kMarkerMapVersion = 2;
+
+// Consecutive all-dark sensor rounds needed to accept a marker; a single
+// noisy round or a sharp curve clipping the outer sensors is not enough
+const unsigned char kMarkerConfirmRounds = 3;
+
+// Shortest distance between two markers; anything closer is the same
+// marker seen twice (e.g. a wobble while crossing it)
+const long kMarkerMinSpacingMm = 80;
+
+class MarkerDetector {
+public:
+  MarkerDetector() : onThreshold(700), offThreshold(400) { reset(0); }
+
+  // Darkness hysteresis (0-1000) for "all sensors see a marker"
+  void setThresholds(int on, int off) {
+    onThreshold = on;
+    offThreshold = off < on ? off : on;
+  }
+
+  // Start counting from zero. A marker the robot is parked on is not
+  // counted: the sensors have to see the floor first.
+  void reset(long distanceMm) {
+    markers = 0;
+    darkRounds = 0;
+    onMarker = true;
+    lastMarkerMm = distanceMm - kMarkerMinSpacingMm;
+  }
+
+  // One sensor round. Returns true when a new marker is confirmed.
+  bool update(const int darkness[kMarkerSensors], long distanceMm) {
+    bool allDark = true;
+    bool anyLight = false;
+    for (unsigned char i = 0; i < kMarkerSensors; i++) {
+      if (darkness[i] <= onThreshold) allDark = false;
+      if (darkness[i] < offThreshold) anyLight = true;
+    }
+
+    if (onMarker) {
+      // Wait until the robot has left the marker
+      if (anyLight) {
+        onMarker = false;
+        darkRounds = 0;
+      }
+      return false;
+    }
+
+    darkRounds = allDark ? darkRounds + 1 : 0;
+    if (darkRounds < kMarkerConfirmRounds) {
+      return false;
+    }
+    onMarker = true;
+    if (distanceMm - lastMarkerMm < kMarkerMinSpacingMm) {
+      return false;
+    }
+    lastMarkerMm = distanceMm;
+    markers++;
+    return true;
+  }
+
+  unsigned char count() const { return markers; }
+
+private:
+  int onThreshold;
+  int offThreshold;
+  unsigned char markers;
+  unsigned char darkRounds;
+  bool onMarker;
+  long lastMarkerMm;
+};
+
+// EEPROM image of the marker map
+struct StoredMarkerMap {
+  unsigned char magic;
+  unsigned char version;
+  unsigned char node[kMarkerMapSize];
+  unsigned short crc;
+};
+
+// Layout node of home (stop 0) and each table. Nodes are the marked points
+// of the route graph, so on a single line node N is simply the Nth marker.
+class MarkerMap {
+public:
+  MarkerMap() { setDefaults(); }
+
+  // Home at node 0, table N at node N
+  void setDefaults() {
+    for (unsigned char i = 0; i < kMarkerMapSize; i++) {
+      map.node[i] = i;
+    }
+  }
+
+  unsigned char nodeFor(unsigned char stop) const {
+    return stop < kMarkerMapSize ? map.node[stop] : 0;
+  }
+
+  bool set(int stop, int node, unsigned char nodeCount) {
+    if (stop < 0 || stop >= kMarkerMapSize || node < 0 || node >= nodeCount) {
+      return false;
+    }
+    map.node[stop] = (unsigned char)node;
+    return true;
+  }
+
+  StoredMarkerMap stored() const {
+    StoredMarkerMap image = map;
+    image.magic = kMarkerMapMagic;
+    image.version = kMarkerMapVersion;
+    image.crc = checksum(image);
+    return image;
+  }
+
+  // Use an EEPROM image if it is intact and fits the layout, otherwise keep
+  // the defaults
+  bool load(const StoredMarkerMap &image, unsigned char nodeCount) {
+    if (image.magic != kMarkerMapMagic || image.version != kMarkerMapVersion ||
+        image.crc != checksum(image)) {
+      return false;
+    }
+    for (unsigned char i = 0; i < kMarkerMapSize; i++) {
+      if (image.node[i] >= nodeCount) {
+        return false;
+      }
+    }
+    map = image;
+    return true;
+  }
+
+private:
+  StoredMarkerMap map;
+
+  static unsigned short checksum(const StoredMarkerMap &image) {
+    return crc16((const unsigned char *)&image, sizeof(image) - sizeof(image.crc));
+  }
+};
+
+#endif
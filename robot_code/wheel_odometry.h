@@ -0,0 +1,120 @@
+// Smart Waiter Robot - Wheel Encoder Odometry
+// Counts encoder edges from both wheels in interrupts and turns them into
+// distance travelled and speed, so arrival no longer depends on how fast
+// the robot happens to be going.
+//
+// Encoders are single-channel (slotted disc or hall sensor), so the
+// direction of each count comes from the motor command, set with
+// setDirections(). The sketch forwards each encoder interrupt:
+//   void leftEncoderISR() { odometry.onLeftTick(); }
+
+#ifndef WHEEL_ODOMETRY_H
+#define WHEEL_ODOMETRY_H
+
+// Speed is smoothed over updates: new = old + (sample - old) / 2^shift
+const unsigned char kSpeedFilterShift = 2;
+
+class WheelOdometry {
+public:
+  // micronsPerTick: wheel circumference / encoder edges per revolution
+  WheelOdometry(unsigned int micronsPerTick)
+    : micronsPerTick(micronsPerTick), leftTicks(0), rightTicks(0), leftStep(1),
+      rightStep(1), startLeft(0), startRight(0), distance(0), lastDistance(0),
+      lastUpdate(0), speed(0) {}
+
+  // Called from the encoder interrupts
+  void onLeftTick() { leftTicks += leftStep; }
+  void onRightTick() { rightTicks += rightStep; }
+
+  // Sign of each wheel's motor command; a stopped wheel keeps its last
+  // direction so coasting is still counted the right way
+  void setDirections(int left, int right) {
+    if (left != 0) leftStep = left > 0 ? 1 : -1;
+    if (right != 0) rightStep = right > 0 ? 1 : -1;
+  }
+
+  // Start measuring a new journey from here
+  void reset(unsigned long nowMillis) {
+    startLeft = readLeft();
+    startRight = readRight();
+    distance = 0;
+    lastDistance = 0;
+    lastUpdate = nowMillis;
+    speed = 0;
+  }
+
+  // Refresh distance and speed; call regularly (every 10-50 ms)
+  void update(unsigned long nowMillis) {
+    long ticks = ((readLeft() - startLeft) + (readRight() - startRight)) / 2;
+    distance = ticks * (long)micronsPerTick / 1000L;
+
+    unsigned long elapsed = nowMillis - lastUpdate;
+    if (elapsed > 0) {
+      long sample = (distance - lastDistance) * 1000L / (long)elapsed;
+      speed += (sample - speed) >> kSpeedFilterShift;
+      lastDistance = distance;
+      lastUpdate = nowMillis;
+    }
+  }
+
+  // Millimetres along the path since reset() (average of both wheels)
+  long distanceMm() const { return distance; }
+
+  // Smoothed forward speed in mm/s
+  long speedMmPerSecond() const { return speed; }
+
+  // Milliseconds to cover the rest of targetMm at the current speed, or -1
+  // if the robot is not moving forward
+  long etaMillis(long targetMm) const {
+    long remaining = targetMm - distance;
+    if (remaining <= 0) {
+      return 0;
+    }
+    if (speed <= 0) {
+      return -1;
+    }
+    return remaining * 1000L / speed;
+  }
+
+  // Share of targetMm covered, 0-100
+  int progressPercent(long targetMm) const {
+    if (targetMm <= 0 || distance >= targetMm) {
+      return 100;
+    }
+    if (distance <= 0) {
+      return 0;
+    }
+    return (int)(distance * 100L / targetMm);
+  }
+
+private:
+  unsigned int micronsPerTick;
+  volatile long leftTicks;
+  volatile long rightTicks;
+  volatile signed char leftStep;
+  volatile signed char rightStep;
+
+  long startLeft;
+  long startRight;
+  long distance;
+  long lastDistance;
+  unsigned long lastUpdate;
+  long speed;
+
+  // Counters are 32-bit, so read them with the interrupts held off
+  long readLeft() {
+    noInterrupts();
+    long ticks = leftTicks;
+    interrupts();
+    return ticks;
+  }
+
+  long readRight() {
+    noInterrupts();
+    long ticks = rightTicks;
+    interrupts();
+    return ticks;
+  }
+};
+
+#endif